@@ -7,16 +7,34 @@
 
 using namespace std;
 
-RandomWord::RandomWord()
+RandomWord::RandomWord() : RandomWord("words.txt", 0)
 {
-	_wordLength = 0;
-	_lettersAdded = 0;
-	_randomWord = nullptr;
+}
 
-	srand(time(NULL));
+RandomWord::RandomWord(const string& fileName, const long& memoryCap) : _fileName(fileName), _memoryCap(memoryCap)
+{
+	resetMembers();
+	seed(time(NULL) ^ (unsigned long long)this);
 	initialize();
 }
 
+RandomWord::RandomWord(const RandomWord* corpusOwner, const bool& firstWord) : _fileName(corpusOwner->_fileName), _memoryCap(corpusOwner->_memoryCap)
+{
+	resetMembers();
+	seed(time(NULL) ^ (unsigned long long)this);
+
+	// Hold the owner's corpus instead of loading our own, which keeps it as it is now for as long as we hold it
+	{
+		lock_guard<mutex> hold(corpusOwner->_corpusLock);
+		_corpus = corpusOwner->_corpus;
+	}
+
+	if (firstWord)
+	{
+		generate();
+	}
+}
+
 RandomWord::~RandomWord()
 {
 	deleteWord();
@@ -25,60 +43,230 @@ RandomWord::~RandomWord()
 
 
 
+// Starts empty, with nothing allocated
+Corpus::Corpus()
+{
+	offsets = nullptr;
+	listSize = 0;
+	listCapacity = 0;
+	arena = nullptr;
+	arenaSize = 0;
+	arenaUsed = 0;
+	deadBytes = 0;
+	slots = nullptr;
+	slotCount = 0;
+	slotsUsed = 0;
+	sampleStride = 1;
+	mappedModel = nullptr;
+	mappedBytes = 0;
+}
+
+// Frees the arrays, or unmaps the model file they point into
+Corpus::~Corpus()
+{
+	// Mapped arrays belong to the model file
+	if (mappedModel != nullptr)
+	{
+		unmapModelFile(mappedModel, mappedBytes);
+	}
+	else
+	{
+		delete[] offsets;
+		delete[] arena;
+		delete[] slots;
+	}
+}
+
+
+
+// Sets every member to its empty value before the corpus is loaded
+void RandomWord::resetMembers()
+{
+	_wordLength = 0;
+	_oneThird = 0;
+	_lettersAdded = 0;
+	_randomWord = nullptr;
+	_wordCapacity = 0;
+	_workBudget = 0;
+	_donorPicks = 0;
+	_budgetExhausted = false;
+	_blocklist = nullptr;
+	_rejectedWords = 0;
+	_lengths = nullptr;
+	_corpus = make_shared<Corpus>();
+	_rngState = 1;
+	_referenceMode = false;
+	_metrics = nullptr;
+}
+
 // Calls the functions to build the random word
 // Returns 0 for failure, 1 for success
 int RandomWord::initialize()
 {
 	int	successValue = 0;
-	int	i;
-
+	int	constructPhase = beginTracePhase("construct RandomWord");
+	int	phase;
 
 	successValue = deleteWord();
 
 	if (successValue != 0)
 	{
-		// Find the size of the incoming list and allocate _donorWordList's array to that size
-		_listSize = allocateDonorList();
-
-		// If the incoming list contains entries
-		if (_listSize != 0)
+		// A model file is mapped as is, with nothing to parse or count
+		if (isModelFile(_fileName))
 		{
-			// Then load the data into the previously allocated _donorWordList
-			loadDB();
-
-			// Generate a word length
-			_wordLength = generateRandomNumber(SMALLEST_WORD, LARGEST_WORD);
-			// Then allocate space for a new word of that length
-			_randomWord = new char[_wordLength + 1];
+			_corpus->listSize = mapModel();
+		}
+		else
+		{
+			// Find the size of the incoming list and allocate the donor list to that size
+			_corpus->listSize = allocateDonorList();
 
-			// Initialize the word to 0's
-			for (i = 0; i < _wordLength; ++i)
+			// If the incoming list contains entries
+			if (_corpus->listSize > 0)
 			{
-				_randomWord[i] = '0';
+				// Then load the data into the previously allocated _corpus->arena and _corpus->offsets
+				loadDB();
 			}
-			// Set the last spot to null
-			_randomWord[_wordLength] = '\0';
+		}
+
+		// If the list contains entries
+		if (_corpus->listSize > 0)
+		{
 
-			// Figure out the size of 1/3 of the word
-			if (_wordLength >= 3)
+			// Now build the first word with no limit on the work done
+			phase = beginTracePhase("first word");
+			successValue = generate();
+			endTracePhase(phase, _wordLength, 0);
+		}
+		// Otherwise the file was opened, but had no entries (or could not be used, which has already been displayed)
+		else
+		{
+			if (_corpus->listSize == 0)
 			{
-				_oneThird = _wordLength / 3;
+				cout << "Error! " << _fileName << " is empty!" << endl;
 			}
+			_corpus->listSize = 0;
+			successValue = -1;
+		}
+	}
 
-			// Now fill the empty spaces with letters
-			successValue = generateLetters();
+	endTracePhase(constructPhase, _corpus->arenaUsed, _corpus->listSize);
+
+	return successValue;
+}
+
+// Generates a new random word from the already loaded donor list
+// workBudget is the most donor words that may be examined for the whole word (0 for no limit)
+// Without a budget each letter after the first examines at most listSize() donor words before falling back to a vowel,
+// so a word of length L examines at most (L - 1) * listSize() (times BLOCKLIST_RETRIES + 1 with a blocklist)
+// Returns 0 for failure, 1 for success, 2 if the budget ran out and the remaining letters were filled with vowels
+int RandomWord::generate(const int& workBudget)
+{
+	int	successValue = 0;
+
+
+	// The budget covers every candidate, including the ones the blocklist rejects
+	_workBudget = workBudget;
+	_donorPicks = 0;
+	_budgetExhausted = false;
+	_rejectedWords = 0;
+
+	successValue = generateCandidate();
+
+	// Replace blocked words until one passes, giving up after BLOCKLIST_RETRIES
+	while ((successValue != 0) && (_blocklist != nullptr) && (_blocklist->blocks(_randomWord)))
+	{
+		if (_rejectedWords >= BLOCKLIST_RETRIES)
+		{
+			deleteWord();
+			successValue = 0;
 		}
-		// Otherwise the file was opened, but had no entries
 		else
 		{
-			cout << "Error! " << _fileName << "is empty!" << endl;
-			successValue = -1;
+			++_rejectedWords;
+			successValue = generateCandidate();
 		}
 	}
 
+	if ((successValue != 0) && (_budgetExhausted))
+	{
+		successValue = 2;
+	}
+
 	return successValue;
 }
 
+// Generates one word of random length into _randomWord
+// Returns 0 for failure, 1 for success
+int RandomWord::generateCandidate()
+{
+	int	successValue = 0;
+	int	i;
+
+
+	if (_corpus->listSize != 0)
+	{
+		_lettersAdded = 0;
+
+		// Generate a word length
+		_wordLength = generateWordLength();
+
+		// Then make room for a word of that length, reusing the last word's buffer when it is big enough
+		if (_wordLength + 1 > _wordCapacity)
+		{
+			deleteWord();
+			_wordCapacity = max(_wordLength, (_lengths != nullptr) ? _lengths->largest() : LARGEST_WORD) + 1;
+			_randomWord = new char[_wordCapacity];
+		}
+
+		// Initialize the word to 0's
+		for (i = 0; i < _wordLength; ++i)
+		{
+			_randomWord[i] = '0';
+		}
+		// Set the last spot to null
+		_randomWord[_wordLength] = '\0';
+
+		// Figure out the size of 1/3 of the word (0 for a two-letter word)
+		_oneThird = _wordLength / 3;
+
+		// Now fill the empty spaces with letters
+		successValue = generateLetters();
+	}
+	else
+	{
+		successValue = 0;
+	}
+
+	return successValue;
+}
+
+// Screens every generated word against blocklist, replacing the ones it blocks (nullptr screens nothing)
+// blocklist is kept rather than copied, so it must outlive its use here
+void RandomWord::setBlocklist(const Blocklist* blocklist)
+{
+	_blocklist = blocklist;
+}
+
+// Returns the number of blocked words replaced by the last call to generate()
+int RandomWord::rejectedWords() const
+{
+	return _rejectedWords;
+}
+
+// Draws the length of every word from lengths instead of uniformly from SMALLEST_WORD to LARGEST_WORD (nullptr restores that)
+// lengths is kept rather than copied, like the blocklist of setBlocklist()
+void RandomWord::setLengthDistribution(const LengthDistribution* lengths)
+{
+	_lengths = ((lengths != nullptr) && (!lengths->empty())) ? lengths : nullptr;
+}
+
+// Returns the number of donor words examined while generating the current word
+int RandomWord::donorPicks() const
+{
+	return _donorPicks;
+}
+
 // Deallocates the dynamic memory in _randomWord
 // returns 0 for failure, 1 for success
 int RandomWord::deleteWord()
@@ -92,6 +280,7 @@ int RandomWord::deleteWord()
 		delete[] _randomWord;
 		_randomWord = nullptr;
 	}
+	_wordCapacity = 0;
 
 	// If null at this point return successful
 	if (_randomWord == nullptr)
@@ -102,23 +291,16 @@ int RandomWord::deleteWord()
 	return successValue;
 }
 
-// Deallocates the dynamic memory in _donorWordList
+// Lets go of the donor list, which is freed or unmapped once no other RandomWord shares it
 // returns 0 for failure, 1 for success
 int RandomWord::deleteDonorList()
 {
 	int successValue = 0;
-	int i;
 
 
-	if (_donorWordList != nullptr)
+	if (_corpus != nullptr)
 	{
-		for (i = 0; i < _listSize; ++i)
-		{
-			delete[] _donorWordList[i];
-			_donorWordList[i] = nullptr;
-		}
-
-		delete[] _donorWordList;
+		_corpus.reset();
 		successValue = 1;
 	}
 
@@ -127,14 +309,78 @@ int RandomWord::deleteDonorList()
 
 
 
-// Scan the incoming .txt file for the number of entries and allocates _donorWordList with that number of elements
-// Returns the size of the _donorWordList
+// Scan the incoming .txt file for the number of entries and allocates the donor list with that number of elements
+// Picks the sample stride first when the full file would not fit in _memoryCap
+// Returns the size of the donor list, or -1 if the file can't be read or _memoryCap can't hold even one word (after displaying why)
 int RandomWord::allocateDonorList()
 {
-	int		i;
-	int		listSize = 0;
+	int			i;
+	int			listSize = 0;
+	int			wordCount;		// Words in the file, all of which are kept without a cap
+	vector<unsigned char>	wordLengths;		// The length of every word in the file, in file order
+	long			corpusBytes = 0;	// Bytes needed to hold the words kept
+
+
+	// First figure out how large the database needs to be
+	wordCount = countDonorFile(wordLengths);
+	if (wordCount < 0)
+	{
+		return -1;
+	}
+
+	// Keep only every nth word until the rest fit under the cap. The sizes of every stride are summed from
+	// wordLengths, so the file is read once here and once by loadDB() however many strides are tried
+	// (the membership table rounds up to a power of 2, so a second widening is occasionally needed)
+	_corpus->sampleStride = 1;
+	while (true)
+	{
+		listSize = 0;
+		_corpus->arenaSize = 0;
+		for (i = 0; i < wordCount; i += _corpus->sampleStride)
+		{
+			// Each word is stored with a length byte before it and a null after it
+			_corpus->arenaSize += wordLengths[i] + 2;
+			++listSize;
+		}
+		corpusBytes = estimateCorpusBytes(listSize, _corpus->arenaSize);
+
+		if ((_memoryCap <= 0) || (corpusBytes <= _memoryCap) || (listSize <= 1))
+		{
+			break;
+		}
+		_corpus->sampleStride = max(_corpus->sampleStride + 1, (int)((corpusBytes * _corpus->sampleStride + _memoryCap - 1) / _memoryCap));
+	}
+
+	// The successor index and the smallest membership table alone can be over a small cap
+	if ((_memoryCap > 0) && (corpusBytes > _memoryCap))
+	{
+		cerr << "Error! A memory cap of " << _memoryCap << " bytes can't hold a corpus of " << _fileName
+			<< ", which needs at least " << corpusBytes << " bytes" << endl;
+		_corpus->arenaSize = 0;
+		return -1;
+	}
+
+	// Then create the database at the correct size
+	_corpus->offsets = new int[listSize];
+	_corpus->listCapacity = listSize;
+	_corpus->arena = new char[_corpus->arenaSize];
+
+	// Initialize all array elements to 0
+	for (i = 0; i < listSize; ++i)
+	{
+		_corpus->offsets[i] = 0;
+	}
+
+	return listSize;
+}
+
+// Reads the length of every word of the incoming .txt file into wordLengths, skipping empty lines
+// Returns the number of words, or -1 if the file can't be read (after displaying why)
+int RandomWord::countDonorFile(vector<unsigned char>& wordLengths)
+{
 	ifstream	in;
 	char            bufferWord[MAX_CHAR];
+	int		phase = beginTracePhase("open file");
 
 
 	// Open the file
@@ -142,95 +388,696 @@ int RandomWord::allocateDonorList()
 	if (!in)
 	{
 		cerr << "Cannot read from " << _fileName << endl;
-		exit(1);
+		return -1;
 	}
+	endTracePhase(phase, 0, 0);
 
-	// First figure out how large the database needs to be
-	while (!in.eof())
+	phase = beginTracePhase("count pass");
+	wordLengths.clear();
+	while (readLine(in, bufferWord))
 	{
-		in.get(bufferWord, MAX_CHAR, '\n');
-		in.get();
-
-		++listSize;
+		if (bufferWord[0] != '\0')
+		{
+			// readLine() keeps at most MAX_CHAR - 1 chars, so the length always fits in one byte
+			wordLengths.push_back((unsigned char)strlen(bufferWord));
+		}
 	}
 	in.close();
+	endTracePhase(phase, 0, wordLengths.size());
 
-	// Then create the database at the correct size
-	_donorWordList = new char* [listSize];
+	return (int)wordLengths.size();
+}
 
-	// Initialize all array elements to nullptr
-	for (i = 0; i < listSize; ++i)
+// Returns the bytes the corpus will need to hold listSize words using arenaSize chars
+long RandomWord::estimateCorpusBytes(const long& listSize, const long& arenaSize) const
+{
+	long	slotCount = 16;
+
+
+	// Same sizing rule loadDB() uses for _corpus->slots
+	while (slotCount < listSize * 2)
 	{
-		_donorWordList[i] = nullptr;
+		slotCount *= 2;
 	}
 
-	return listSize;
+	return arenaSize + (listSize * (long)sizeof(int)) + (slotCount * (long)sizeof(int)) + (long)sizeof(SuccessorIndex);
 }
 
-// Loads the entries from the incoming .txt file into the previously allocated _donorWordList
-// Returns 0 if the file can't open, -1 if the file is empty, and 1 for success
+// Loads the entries from the incoming .txt file into the previously allocated arena and offsets of _corpus
+// Returns 0 if the file can't open (setting the list size to -1), -1 if the file is empty, and 1 for success
 int RandomWord::loadDB()
 {
 	int		successValue = 0;	// Success or failure value
 	ifstream	in;			// Name of the incoming file stream
-	int             i = 0;			// Index for the _donorWordList
-	char            bufferWord[MAX_CHAR];	// Buffer for next word to add to _donorWordList
+	int             i = 0;			// Index for the _corpus->offsets
+	char            bufferWord[MAX_CHAR];	// Buffer for next word to add to the donor list
 	int             bufferWordLength;	// Length of the current buffer word
-	char*		wordToAdd;		// Pointer to the new word to add to _donorWordList
+	int		arenaUsed = 0;		// Number of chars of _corpus->arena already filled
+	int		wordNumber = 0;		// Words of the file read so far, kept or not
+	int		phase = beginTracePhase("open file");
 	
 
 	// Open the file
 	in.open(_fileName);
 	if (!in)
 	{
+		// The file was counted a moment ago, so it was removed or locked since
 		cerr << "Cannot read from " << _fileName << endl;
-		exit(1);
+		_corpus->listSize = -1;
+		return 0;
 	}
 	else
 	{
 		successValue = 1;
 	}
+	endTracePhase(phase, 0, 0);
+
+	phase = beginTracePhase("copy pass");
 
-	// Now fill up the array
-	while (!in.eof())
+	// Now fill up the array (stopping at _corpus->listSize in case the file grew since it was counted)
+	while ((i < _corpus->listSize) && (readLine(in, bufferWord)))
 	{
-		// Copies the information from the file into a word buffer
-		in.get(bufferWord, MAX_CHAR, '\n');
-		// gets rid of the newline
-		in.get();
+		// Skip empty lines, and the words left out to fit the memory cap
+		if ((bufferWord[0] == '\0') || (((wordNumber++) % _corpus->sampleStride) != 0))
+		{
+			continue;
+		}
 
 		// Get the length of the word in the buffer;
 		bufferWordLength = strlen(bufferWord);
+		if (arenaUsed + bufferWordLength + 2 > _corpus->arenaSize)
+		{
+			break;
+		}
 
+		// Copy the buffer's length, then the buffer with its null, into the next free space of the arena
+		// (readLine() keeps at most MAX_CHAR - 1 chars, so the length always fits in one byte)
+		_corpus->arena[arenaUsed] = (char)bufferWordLength;
+		memcpy(_corpus->arena + arenaUsed + 1, bufferWord, bufferWordLength + 1);
 
-		// Create a cstring dynamically that is the right length for the new word
-		wordToAdd = new char[bufferWordLength + 1];
+		// Add the newWord to the array
+		_corpus->offsets[i] = arenaUsed + 1;
+		arenaUsed += bufferWordLength + 2;
 
+		i++;
+	}
+	in.close();
 
+	// If the file shrank since it was counted, only keep what was read
+	_corpus->listSize = i;
+	_corpus->arenaUsed = arenaUsed;
+	endTracePhase(phase, _corpus->arenaUsed, wordNumber);
 
-		// Copy the buffer into the newly-created cstring
-		strcpy_s(wordToAdd, (bufferWordLength + 1), bufferWord);
+	// Index every word so it can be found again by removeDonorWord()
+	phase = beginTracePhase("membership table");
+	i = 16;
+	while (i < _corpus->listSize * 2)
+	{
+		i *= 2;
+	}
+	rebuildDonorSlots(i);
+	endTracePhase(phase, (long long)_corpus->slotCount * sizeof(int), _corpus->listSize);
 
-		// Add the newWord to the array
-		_donorWordList[i] = wordToAdd;
+	// Count which letters each third of the donor words can supply
+	phase = beginTracePhase("successor index");
+	_corpus->successorIndex.build(_corpus->arena, _corpus->offsets, _corpus->listSize, 0);
+	endTracePhase(phase, sizeof(SuccessorIndex), _corpus->listSize);
 
-		i++;
+	if (_corpus->listSize == 0)
+	{
+		successValue = -1;
 	}
-	in.close();
 
 	return successValue;
 }
 
 
 
+// Adds a copy of word to the end of the donor list so later words can draw from it
+// Takes time proportional to the word, unless the donor list is shared with another generator or a model file,
+// in which case it is copied first so they keep the words they had
+// Returns 0 if the word is empty, too long, or already in the list, 1 for success
+int RandomWord::addDonorWord(const char word[])
+{
+	int	successValue = 0;
+	int	wordLength = strlen(word);
+	int*	grownOffsets;		// Larger replacement for _corpus->offsets when it is full
+	char*	grownArena;		// Larger replacement for _corpus->arena when it is full
+	int	i;
+	lock_guard<mutex>	hold(_corpusLock);
+
+
+	if ((wordLength > 0) && (wordLength < MAX_CHAR) && (findDonorSlot(word) == -1) && (privatizeCorpus() != 0))
+	{
+		// Double the capacity when full so a run of additions costs constant time per word
+		if (_corpus->listSize == _corpus->listCapacity)
+		{
+			_corpus->listCapacity = (_corpus->listCapacity > 0) ? (_corpus->listCapacity * 2) : 16;
+			grownOffsets = new int[_corpus->listCapacity];
+			for (i = 0; i < _corpus->listSize; ++i)
+			{
+				grownOffsets[i] = _corpus->offsets[i];
+			}
+			delete[] _corpus->offsets;
+			_corpus->offsets = grownOffsets;
+		}
+		if (_corpus->arenaUsed + wordLength + 2 > _corpus->arenaSize)
+		{
+			_corpus->arenaSize = max(_corpus->arenaSize * 2, _corpus->arenaUsed + wordLength + 2);
+			grownArena = new char[_corpus->arenaSize];
+			memcpy(grownArena, _corpus->arena, _corpus->arenaUsed);
+			delete[] _corpus->arena;
+			_corpus->arena = grownArena;
+		}
+
+		_corpus->arena[_corpus->arenaUsed] = (char)wordLength;
+		memcpy(_corpus->arena + _corpus->arenaUsed + 1, word, wordLength + 1);
+		_corpus->offsets[_corpus->listSize] = _corpus->arenaUsed + 1;
+		_corpus->arenaUsed += wordLength + 2;
+		++_corpus->listSize;
+		_corpus->successorIndex.updateWord(word, 1);
+
+		successValue = insertDonorSlot(_corpus->listSize - 1);
+	}
+
+	return successValue;
+}
+
+// Removes word from the donor list by moving the last entry into its place, copying the list first like addDonorWord()
+// Returns 0 if the word is not in the list, 1 for success
+int RandomWord::removeDonorWord(const char word[])
+{
+	int	successValue = 0;
+	int	slot;
+	int	listIndex;		// Position of word in the donor list
+	int	lastSlot;		// Slot of the last entry of the donor list, which moves into listIndex
+	lock_guard<mutex>	hold(_corpusLock);
+
+
+	slot = findDonorSlot(word);
+	if ((slot != -1) && (privatizeCorpus() != 0))
+	{
+		listIndex = _corpus->slots[slot];
+		_corpus->slots[slot] = REMOVED_SLOT;
+		_corpus->successorIndex.updateWord(donorWord(listIndex), -1);
+		_corpus->deadBytes += donorLength(listIndex) + 2;
+
+		// Fill the hole with the last entry and point its slot at the new position
+		// (a duplicate line of the .txt file has no slot of its own, so only a slot holding the last index moves)
+		--_corpus->listSize;
+		if (listIndex != _corpus->listSize)
+		{
+			lastSlot = findDonorSlot(donorWord(_corpus->listSize));
+			_corpus->offsets[listIndex] = _corpus->offsets[_corpus->listSize];
+			if ((lastSlot != -1) && (_corpus->slots[lastSlot] == _corpus->listSize))
+			{
+				_corpus->slots[lastSlot] = listIndex;
+			}
+		}
+
+		// The word's chars stay in the arena until removed words make up half of it,
+		// so the copy made by compactArena() is paid for by the removals before it
+		if ((_corpus->deadBytes >= COMPACT_MIN_BYTES) && (_corpus->deadBytes * 2 > _corpus->arenaUsed))
+		{
+			compactArena();
+		}
+
+		successValue = 1;
+	}
+
+	return successValue;
+}
+
+// Returns the number of donor words currently in the donor list
+int RandomWord::listSize() const
+{
+	return _corpus->listSize;
+}
+
+// Check if word is in the donor list
+// Returns true if it is
+bool RandomWord::isDonorWord(const char word[]) const
+{
+	return (findDonorSlot(word) != -1);
+}
+
+
+
+// Fills stats with the bytes held by each part of this RandomWord
+void RandomWord::memoryStats(MemoryStats& stats) const
+{
+	stats.arenaBytes = _corpus->arenaSize;
+	stats.offsetBytes = (long)_corpus->listCapacity * sizeof(int);
+	stats.slotBytes = (long)_corpus->slotCount * sizeof(int);
+	stats.indexBytes = sizeof(SuccessorIndex);
+	stats.scratchBytes = _wordCapacity;
+	stats.totalBytes = stats.arenaBytes + stats.offsetBytes + stats.slotBytes + stats.indexBytes + stats.scratchBytes;
+	stats.sharedBytes = ((_corpus->mappedModel != nullptr) || (_corpus.use_count() > 1)) ? (stats.arenaBytes + stats.offsetBytes + stats.slotBytes) : 0;
+	stats.sampleStride = _corpus->sampleStride;
+}
+
+// Displays the memoryStats() breakdown
+void RandomWord::displayMemoryReport() const
+{
+	MemoryStats	stats;
+
+
+	memoryStats(stats);
+
+	headerBox("Memory");
+	cout << "Donor words:        " << _corpus->listSize << endl;
+	cout << "Sample stride:      " << stats.sampleStride << (stats.sampleStride == 1 ? " (every word)" : " (capped)") << endl;
+	cout << "Word arena:         " << stats.arenaBytes << " bytes" << endl;
+	cout << "Offset table:       " << stats.offsetBytes << " bytes" << endl;
+	cout << "Membership index:   " << stats.slotBytes << " bytes" << endl;
+	cout << "Successor index:    " << stats.indexBytes << " bytes" << endl;
+	cout << "Word scratch:       " << stats.scratchBytes << " bytes" << endl;
+	cout << "Total:              " << stats.totalBytes << " bytes" << endl;
+	if (_corpus->mappedModel != nullptr)
+	{
+		cout << "Shared (mapped):    " << stats.sharedBytes << " bytes of " << _fileName << endl;
+	}
+	else if (_corpus.use_count() > 1)
+	{
+		cout << "Shared (borrowed):  " << stats.sharedBytes << " bytes with other generators" << endl;
+	}
+	if (_memoryCap > 0)
+	{
+		cout << "Memory cap:         " << _memoryCap << " bytes" << endl;
+	}
+}
+
+
+
+// Returns the hash of a word used to place it in the membership table
+// (32-bit FNV-1a)
+unsigned int RandomWord::hashWord(const char word[]) const
+{
+	unsigned int	hash = 2166136261u;
+	int		i;
+
+
+	for (i = 0; word[i] != '\0'; ++i)
+	{
+		hash ^= (unsigned char)word[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+// Finds the slot in the membership table holding the index of word
+// Returns the slot, or -1 if the word is not in the donor list
+int RandomWord::findDonorSlot(const char word[]) const
+{
+	int	slot;
+	int	i;
+
+
+	if (_corpus->slotCount == 0)
+	{
+		return -1;
+	}
+
+	// Probe linearly from the hashed slot until the word or a never-used slot is found
+	slot = hashWord(word) & (_corpus->slotCount - 1);
+	for (i = 0; i < _corpus->slotCount; ++i)
+	{
+		if (_corpus->slots[slot] == EMPTY_SLOT)
+		{
+			break;
+		}
+		if ((_corpus->slots[slot] != REMOVED_SLOT) && (!strcmp(donorWord(_corpus->slots[slot]), word)))
+		{
+			return slot;
+		}
+		slot = (slot + 1) & (_corpus->slotCount - 1);
+	}
+
+	return -1;
+}
+
+// Records the donor list index listIndex in the membership table
+// When the table is half full it is rebuilt with SLOT_HEADROOM slots per word, so that the next rebuild is listSize() inserts away
+// Returns 0 for failure, 1 for success
+int RandomWord::insertDonorSlot(const int& listIndex)
+{
+	int	slot;
+	int	slotCount;		// Size of the rebuilt table when this one is too full
+
+
+	// Keep the table at most half full, counting removed slots, so probes stay short
+	// (a rebuild to only twice the words could leave it exactly half full, and rebuild again on the next insert)
+	if ((_corpus->slotsUsed + 1) * 2 > _corpus->slotCount)
+	{
+		slotCount = 16;
+		while (slotCount < _corpus->listSize * SLOT_HEADROOM)
+		{
+			slotCount *= 2;
+		}
+		return rebuildDonorSlots(slotCount);
+	}
+
+	slot = hashWord(donorWord(listIndex)) & (_corpus->slotCount - 1);
+	while ((_corpus->slots[slot] != EMPTY_SLOT) && (_corpus->slots[slot] != REMOVED_SLOT))
+	{
+		// Duplicate lines in the .txt file keep only their first index
+		if (!strcmp(donorWord(_corpus->slots[slot]), donorWord(listIndex)))
+		{
+			return 1;
+		}
+		slot = (slot + 1) & (_corpus->slotCount - 1);
+	}
+
+	if (_corpus->slots[slot] == EMPTY_SLOT)
+	{
+		++_corpus->slotsUsed;
+	}
+	_corpus->slots[slot] = listIndex;
+
+	return 1;
+}
+
+// Reallocates the membership table with slotCount entries and re-inserts every word in the donor list
+// Returns 0 for failure, 1 for success
+int RandomWord::rebuildDonorSlots(const int& slotCount)
+{
+	int	i;
+
+
+	delete[] _corpus->slots;
+	_corpus->slotCount = slotCount;
+	_corpus->slotsUsed = 0;
+	_corpus->slots = new int[_corpus->slotCount];
+
+	for (i = 0; i < _corpus->slotCount; ++i)
+	{
+		_corpus->slots[i] = EMPTY_SLOT;
+	}
+
+	for (i = 0; i < _corpus->listSize; ++i)
+	{
+		insertDonorSlot(i);
+	}
+
+	return 1;
+}
+
+// Returns the donor word at listIndex (0 to listSize() - 1)
+const char* RandomWord::donorWord(const int& listIndex) const
+{
+	return _corpus->arena + _corpus->offsets[listIndex];
+}
+
+// Returns the successor counts of the donor list, which fillSection() draws letters in proportion to
+const SuccessorIndex& RandomWord::successorIndex() const
+{
+	return _corpus->successorIndex;
+}
+
+// Returns the length of the donor word at listIndex, read from the arena instead of counted
+int RandomWord::donorLength(const int& listIndex) const
+{
+	return (unsigned char)_corpus->arena[_corpus->offsets[listIndex] - 1];
+}
+
+
+
+// Writes count bytes to out and adds them to checksum
+static void writeModelBytes(ofstream& out, unsigned long long& checksum, const char bytes[], const long long& count)
+{
+	out.write(bytes, count);
+	addModelChecksum(checksum, bytes, count);
+}
+
+// Writes the loaded corpus, membership table, and successor index to fileName
+// so other processes can map it with the fileName constructor
+// Returns 0 for failure, 1 for success
+int RandomWord::saveModel(const string& fileName) const
+{
+	ModelHeader	header;
+	ofstream	out;
+	const char	padding[MODEL_ALIGNMENT] = { 0 };
+
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+	header.version = MODEL_VERSION;
+	header.listSize = _corpus->listSize;
+	header.arenaUsed = _corpus->arenaUsed;
+	header.slotCount = _corpus->slotCount;
+	header.slotsUsed = _corpus->slotsUsed;
+	header.sampleStride = _corpus->sampleStride;
+
+	// Lay the sections out one after another, each on its own cache line
+	header.offsetsAt = alignModelOffset(sizeof(header));
+	header.arenaAt = alignModelOffset(header.offsetsAt + (long long)_corpus->listSize * sizeof(int));
+	header.slotsAt = alignModelOffset(header.arenaAt + _corpus->arenaUsed);
+	header.indexAt = alignModelOffset(header.slotsAt + (long long)_corpus->slotCount * sizeof(int));
+	header.fileBytes = header.indexAt + sizeof(SuccessorIndex);
+
+	out.open(fileName, ios::binary | ios::trunc);
+	if (!out)
+	{
+		cerr << "Cannot write to " << fileName << endl;
+		return 0;
+	}
+
+	// Every section goes through the checksum on its way out, and the header is written again once it is known
+	header.checksum = MODEL_CHECKSUM_START;
+	out.write((const char*)&header, sizeof(header));
+	writeModelBytes(out, header.checksum, padding, header.offsetsAt - sizeof(header));
+	writeModelBytes(out, header.checksum, (const char*)_corpus->offsets, (long long)_corpus->listSize * sizeof(int));
+	writeModelBytes(out, header.checksum, padding, header.arenaAt - (header.offsetsAt + (long long)_corpus->listSize * sizeof(int)));
+	writeModelBytes(out, header.checksum, _corpus->arena, _corpus->arenaUsed);
+	writeModelBytes(out, header.checksum, padding, header.slotsAt - (header.arenaAt + _corpus->arenaUsed));
+	writeModelBytes(out, header.checksum, (const char*)_corpus->slots, (long long)_corpus->slotCount * sizeof(int));
+	writeModelBytes(out, header.checksum, padding, header.indexAt - (header.slotsAt + (long long)_corpus->slotCount * sizeof(int)));
+	writeModelBytes(out, header.checksum, (const char*)&_corpus->successorIndex, sizeof(SuccessorIndex));
+	out.seekp(0);
+	out.write((const char*)&header, sizeof(header));
+	out.close();
+
+	return (out) ? 1 : 0;
+}
+
+// Maps the model file _fileName and points the donor list at it
+// Returns the size of the donor list, or -1 if the file can't be mapped or is not a usable model (after displaying why)
+int RandomWord::mapModel()
+{
+	const ModelHeader*	header;
+	int			phase = beginTracePhase("map model");
+
+
+	_corpus->mappedModel = mapModelFile(_fileName, _corpus->mappedBytes);
+	if (_corpus->mappedModel == nullptr)
+	{
+		cerr << "Cannot map " << _fileName << endl;
+		return -1;
+	}
+
+	// Nothing in the file is used before it is checked, so a truncated or damaged model is refused instead of read out of bounds
+	header = (const ModelHeader*)_corpus->mappedModel;
+	if ((_corpus->mappedBytes < (long long)sizeof(ModelHeader)) || (header->version != MODEL_VERSION) ||
+		(!modelHeaderValid(*header, _corpus->mappedBytes, sizeof(SuccessorIndex))))
+	{
+		cerr << "Error! " << _fileName << " is not a model this version can read" << endl;
+		_corpus = make_shared<Corpus>();
+		return -1;
+	}
+
+	// Every array points straight into the shared pages, nothing is copied but the small successor counts
+	_corpus->listSize = header->listSize;
+	_corpus->listCapacity = header->listSize;
+	_corpus->offsets = (int*)(_corpus->mappedModel + header->offsetsAt);
+	_corpus->arena = (char*)(_corpus->mappedModel + header->arenaAt);
+	_corpus->arenaSize = header->arenaUsed;
+	_corpus->arenaUsed = header->arenaUsed;
+	_corpus->slots = (int*)(_corpus->mappedModel + header->slotsAt);
+	_corpus->slotCount = header->slotCount;
+	_corpus->slotsUsed = header->slotsUsed;
+	_corpus->sampleStride = header->sampleStride;
+	memcpy((void*)&_corpus->successorIndex, _corpus->mappedModel + header->indexAt, sizeof(SuccessorIndex));
+
+	// The successor counts are a fixed size, so they are checked now; the words and slots wait for modelIntact()
+	if (!_corpus->successorIndex.valid())
+	{
+		cerr << "Error! " << _fileName << " is a damaged model" << endl;
+		_corpus = make_shared<Corpus>();
+		return -1;
+	}
+	endTracePhase(phase, _corpus->mappedBytes, _corpus->listSize);
+
+	return _corpus->listSize;
+}
+
+// Check if a mapped model still matches its checksum and every donor word and membership slot can be used
+// as it is, reading the whole file (mapping only checks the header and section bounds, see modelFile.h)
+// Returns true if it does, or if the corpus isn't mapped from a model
+bool RandomWord::modelIntact() const
+{
+	shared_ptr<Corpus>	corpus;
+	const ModelHeader*	header;
+	unsigned long long	checksum = MODEL_CHECKSUM_START;
+	int			offset;
+	int			i;
+
+
+	{
+		lock_guard<mutex>	hold(_corpusLock);
+		corpus = _corpus;
+	}
+	if ((corpus == nullptr) || (corpus->mappedModel == nullptr))
+	{
+		return true;
+	}
+
+	header = (const ModelHeader*)corpus->mappedModel;
+	addModelChecksum(checksum, corpus->mappedModel + sizeof(ModelHeader), corpus->mappedBytes - sizeof(ModelHeader));
+	if (checksum != header->checksum)
+	{
+		return false;
+	}
+
+	for (i = 0; i < corpus->listSize; ++i)
+	{
+		// The length byte before the word and the null after it must both be in the arena
+		offset = corpus->offsets[i];
+		if ((offset < 1) || (offset >= corpus->arenaUsed) ||
+			(offset + (unsigned char)corpus->arena[offset - 1] >= corpus->arenaUsed) || (corpus->arena[offset + (unsigned char)corpus->arena[offset - 1]] != '\0'))
+		{
+			return false;
+		}
+	}
+
+	// Every slot is a marker or a list index
+	for (i = 0; i < corpus->slotCount; ++i)
+	{
+		if ((corpus->slots[i] < REMOVED_SLOT) || (corpus->slots[i] >= corpus->listSize))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Copies _corpus into our own memory when a model file or another RandomWord shares it, so it can be changed
+// Must be called with _corpusLock held
+// Returns 0 for failure, 1 for success
+int RandomWord::privatizeCorpus()
+{
+	shared_ptr<Corpus>	copy;
+
+
+	// Nobody else can see the corpus, so it can be changed in place
+	if ((_corpus.use_count() == 1) && (_corpus->mappedModel == nullptr))
+	{
+		return 1;
+	}
+
+	copy = make_shared<Corpus>();
+	copy->listSize = _corpus->listSize;
+	copy->listCapacity = _corpus->listCapacity;
+	copy->arenaSize = _corpus->arenaSize;
+	copy->arenaUsed = _corpus->arenaUsed;
+	copy->deadBytes = _corpus->deadBytes;
+	copy->slotCount = _corpus->slotCount;
+	copy->slotsUsed = _corpus->slotsUsed;
+	copy->successorIndex = _corpus->successorIndex;
+	copy->sampleStride = _corpus->sampleStride;
+
+	copy->offsets = new int[copy->listCapacity];
+	copy->arena = new char[copy->arenaSize];
+	copy->slots = new int[copy->slotCount];
+	std::copy(_corpus->offsets, _corpus->offsets + _corpus->listSize, copy->offsets);
+	std::copy(_corpus->arena, _corpus->arena + _corpus->arenaUsed, copy->arena);
+	std::copy(_corpus->slots, _corpus->slots + _corpus->slotCount, copy->slots);
+
+	// The generators sharing the old corpus keep it, and the last of them frees or unmaps it
+	_corpus = copy;
+
+	return 1;
+}
+
+// Moves the donor words together in a new arena, dropping the chars of removed words
+// Returns 0 for failure, 1 for success
+int RandomWord::compactArena()
+{
+	char*	arena = new char[_corpus->arenaUsed - _corpus->deadBytes];
+	int	arenaUsed = 0;		// Number of chars of the new arena already filled
+	int	wordBytes;		// Chars of the current word, with its length and null
+	int	i;
+
+
+	for (i = 0; i < _corpus->listSize; ++i)
+	{
+		wordBytes = donorLength(i) + 2;
+		memcpy(arena + arenaUsed, _corpus->arena + _corpus->offsets[i] - 1, wordBytes);
+		_corpus->offsets[i] = arenaUsed + 1;
+		arenaUsed += wordBytes;
+	}
+
+	// The membership table holds list indices, which don't move, so it is left as it is
+	delete[] _corpus->arena;
+	_corpus->arena = arena;
+	_corpus->arenaSize = _corpus->arenaUsed - _corpus->deadBytes;
+	_corpus->arenaUsed = arenaUsed;
+	_corpus->deadBytes = 0;
+
+	return 1;
+}
+
+
+
+// Restarts this generator's random number sequence from seedValue
+void RandomWord::seed(const unsigned long long& seedValue)
+{
+	// Spread the seed over all 64 bits (splitmix64) so nearby seeds give unrelated sequences
+	_rngState = seedValue + 0x9E3779B97F4A7C15ULL;
+	_rngState = (_rngState ^ (_rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	_rngState = (_rngState ^ (_rngState >> 27)) * 0x94D049BB133111EBULL;
+	_rngState ^= _rngState >> 31;
+
+	// xorshift never leaves 0
+	if (_rngState == 0)
+	{
+		_rngState = 1;
+	}
+}
+
+// With reference true, fillSection() runs the original algorithm: no successor index shortcut, and donor lengths
+// are counted instead of read from the arena. Only used to check optimizations against it (see verify.h)
+void RandomWord::setReferenceMode(const bool& reference)
+{
+	_referenceMode = reference;
+}
+
+// Counts every letter fillSection() fills in, and every vowel fallback, into metrics (nullptr counts nothing)
+// metrics must belong to the thread calling generate()
+void RandomWord::setMetrics(ThreadMetrics* metrics)
+{
+	_metrics = metrics;
+}
+
+// Returns the next 32 random bits of this generator's own sequence (xorshift64*)
+unsigned int RandomWord::nextRandom()
+{
+	_rngState ^= _rngState >> 12;
+	_rngState ^= _rngState << 25;
+	_rngState ^= _rngState >> 27;
+
+	return (unsigned int)((_rngState * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
 // Returns a random number between the bounds (inclusive)
-int RandomWord::generateRandomNumber(const int& lowerBound, const int& upperBound) const
+int RandomWord::generateRandomNumber(const int& lowerBound, const int& upperBound)
 {
 	int	randomNumber;
 	int	range = (upperBound - lowerBound);
 
 	// An amount to add onto the lower range
-	randomNumber = rand() % (range + 1);
+	randomNumber = nextRandom() % (range + 1);
 
 	// Now add the lower range to get the length of the word
 	randomNumber += lowerBound;
@@ -241,36 +1088,24 @@ int RandomWord::generateRandomNumber(const int& lowerBound, const int& upperBoun
 // Returns a random lowercase letter
 char RandomWord::generateRandomLetter()
 {
-	return generateRandomNumber(97, 122);
+	return sampleLetter(nextRandom());
 }
 
 // Returns a random lowercase vowel
 char RandomWord::generateRandomVowel()
 {
-	int	vowelNumber = generateRandomNumber(1, 5);
-	char	returnChar;
+	return sampleVowel(nextRandom());
+}
 
-	switch (vowelNumber) {
-	case 1:
-		returnChar = 'a';
-		break;
-	case 2:
-		returnChar = 'e';
-		break;
-	case 3:
-		returnChar = 'i';
-		break;
-	case 4:
-		returnChar = 'o';
-		break;
-	case 5:
-		returnChar = 'u';
-		break;
-	default:
-		returnChar = 1;
+// Returns a word length drawn from _lengths, or from SMALLEST_WORD to LARGEST_WORD without one
+int RandomWord::generateWordLength()
+{
+	if (_lengths != nullptr)
+	{
+		return _lengths->sample(nextRandom());
 	}
 
-	return returnChar;
+	return generateRandomNumber(SMALLEST_WORD, LARGEST_WORD);
 }
 
 
@@ -293,8 +1128,6 @@ int RandomWord::generateLetters()
 	}
 	else
 	{
-		int test;
-
 		// Add the first letter randomly
 		if (_lettersAdded == 0)
 		{
@@ -312,14 +1145,14 @@ int RandomWord::generateLetters()
 		// have been added because the first 1/3 rounded down is only 1 letter
 		if (_wordLength > 5)
 		{
-			successValue = (this->fillSection)(&RandomWord::firstThird, &RandomWord::firstDonor);
+			successValue = (this->fillSection)(&RandomWord::firstThird, &RandomWord::firstDonor, 0);
 		}
 		if (successValue != 0)
 		{
-			successValue = (this->fillSection)(&RandomWord::middleThird, &RandomWord::middleDonor);
+			successValue = (this->fillSection)(&RandomWord::middleThird, &RandomWord::middleDonor, 1);
 			if (successValue != 0)
 			{
-				(this->fillSection)(&RandomWord::lastThird, &RandomWord::lastDonor);
+				(this->fillSection)(&RandomWord::lastThird, &RandomWord::lastDonor, 2);
 			}
 		}
 	}
@@ -328,57 +1161,34 @@ int RandomWord::generateLetters()
 }
 
 // Generates a random two-letter word containing 1 lowercase vowel and 1 lowercase consonant in random order
-// Returns 0 for failure, 1 for success
+// Returns the number of letters generated
 int RandomWord::generateTwoLetterWord()
 {
-	int	successValue = 0;
-	int	lettersGenerated = 0;
-	char	charBuffer;
-
 	// Generate a random first letter
-	charBuffer = generateRandomLetter();
-	_randomWord[0] = charBuffer;
-	++lettersGenerated;
-
-	// If the first generated letter was a vowel, do not generate another vowel
-	if ((charBuffer == 'a') || (charBuffer == 'e') || (charBuffer == 'i') || (charBuffer == 'o') || (charBuffer == 'u'))
-	{
-		// Generate a random letter
-		charBuffer = generateRandomLetter();
+	_randomWord[0] = generateRandomLetter();
 
-		// If that letter is a vowel, keep generating letters until a non-vowel is generated
-		while ((charBuffer == 'a') || (charBuffer == 'e') || (charBuffer == 'i') || (charBuffer == 'o') || (charBuffer == 'u'))
-		{
-			charBuffer = generateRandomLetter();
-		}
-		_randomWord[1] = charBuffer;
+	// Then draw the second straight from the other class: a consonant after a vowel, a vowel after a consonant
+	_randomWord[1] = sampleOpposite(_randomWord[0], nextRandom());
 
-		++lettersGenerated;
-		successValue = 1;
-	}
-	// Otherwise, generate a random vowel to follow the first letter
-	else
-	{
-		charBuffer = generateRandomVowel();
-		_randomWord[1] = charBuffer;
-
-		++lettersGenerated;
-		successValue = 1;
-	}
-
-	return lettersGenerated;
+	return 2;
 }
 
 // Fills letters into _randomWord based on the given functions which will provide the needed index bounds
+// section is the matching row of the successor index (0 first, 1 middle, 2 last third)
 // Returns 0 for failure, 1 for success
-int RandomWord::fillSection(void (RandomWord::* boundaryFunction)(int& upperBoundary), void (RandomWord::* donorBoundary)(int& donorLength, int& donorLower, int& donorUpper))
+int RandomWord::fillSection(void (RandomWord::* boundaryFunction)(int& upperBoundary), void (RandomWord::* donorBoundary)(int& donorLength, int& donorLower, int& donorUpper), const int& section)
 {
 	int	successValue = 0;	// Success or failure of function
-	int	numberOfTries = 0;	// Number of times the function has picked a random word from the _donorWordList database and failed to find a match
+	int	numberOfTries = 0;	// Number of times the function has picked a random word from the donor list for the current letter
 	int	lastLetterIndex;	// Index of the last letter added to _randomWord
+	int	lastLetter;		// letterIndex() of the last letter added to _randomWord
 	int	nextLetterIndex;	// Index of the next letter that will be added to _randomWord
-	int	donorWordIndex;		// Index of the current donorWord in the _donorWordList database
+	int	donorWordIndex;		// Index of the current donorWord in the donor list
+	const char*	donor;		// The current donor word
 	int	i;			// Index of the current position within the donorWord
+	int	firstLetter = _lettersAdded;	// Letters already in _randomWord, for _metrics
+	int	fallbacks = 0;		// Letters that fell back to a vowel, for _metrics
+	const Corpus&	corpus = *_corpus;	// The donor words, looked up once for the whole section
 
 	int	_upperBoundary;		// The index position of _randomWord which this function will stop before reaching
 	int	_donorLength;		// The length of the current donor word
@@ -395,64 +1205,92 @@ int RandomWord::fillSection(void (RandomWord::* boundaryFunction)(int& upperBoun
 		// Index of the last letter added to _randomWord
 		lastLetterIndex = _lettersAdded - 1;
 		nextLetterIndex = _lettersAdded;
+		lastLetter = letterIndex(_randomWord[lastLetterIndex]);
+		numberOfTries = 0;
 
-		// Get a random Index from our database which will be our donor word
-		donorWordIndex = generateRandomNumber(0, (_listSize - 1));
-		_donorLength = strlen(_donorWordList[donorWordIndex]);
-
-		(this->*donorBoundary)(_donorLength, _donorLower, _donorUpper);
+		// If no donor word can follow the last letter in this third, every try would fail,
+		// so go straight to the vowel instead of searching every donor word
+		if ((!_referenceMode) && (corpus.successorIndex.total(section, _randomWord[lastLetterIndex]) == 0))
+		{
+			numberOfTries = corpus.listSize;
+		}
 
-		// i is the position within the donor word
-		i = _donorLower;
-		// While we are within the correct range for this portion of our word
-		// AND we haven't already found a match to pull the next letter from
-		while ((i < _donorUpper) && (_lettersAdded == nextLetterIndex))
+		// Keep picking donor words until one supplies the next letter,
+		// the letter has used its share of tries, or the word has used its budget
+		while ((_lettersAdded == nextLetterIndex) && (numberOfTries < corpus.listSize) && (!budgetSpent()))
 		{
-			// If the current i position isn't the last in the donor word
-			// AND the letter at the index matches the letter that was last added
-			if ((i < strlen(_donorWordList[donorWordIndex])) &&
-				(tolower(_donorWordList[donorWordIndex][i]) == tolower(_randomWord[lastLetterIndex])))
+			// Get a random Index from our database which will be our donor word
+			donorWordIndex = generateRandomNumber(0, (corpus.listSize - 1));
+			donor = corpus.arena + corpus.offsets[donorWordIndex];
+			_donorLength = (_referenceMode) ? strlen(donor) : (unsigned char)donor[-1];
+
+			(this->*donorBoundary)(_donorLength, _donorLower, _donorUpper);
+
+			// i is the position within the donor word
+			i = _donorLower;
+			// While we are within the correct range for this portion of our word
+			// AND we haven't already found a match to pull the next letter from
+			while ((i < _donorUpper) && (_lettersAdded == nextLetterIndex))
 			{
-				// Only add the letter if it's an alpha letter
-				if (checkChar(_donorWordList[donorWordIndex][i + 1]))
+				// If the current i position isn't the last in the donor word
+				// AND the letter at the index matches the letter that was last added
+				if ((i < _donorLength) &&
+					(letterIndex(donor[i]) == lastLetter))
 				{
-					// Then add the next letter in the donor word to the current word.
-					_randomWord[nextLetterIndex] = _donorWordList[donorWordIndex][i + 1];
-					++_lettersAdded;
-
-					successValue = 1;
+					// Only add the letter if it's an alpha letter
+					if (checkChar(donor[i + 1]))
+					{
+						// Then add the next letter in the donor word to the current word.
+						_randomWord[nextLetterIndex] = donor[i + 1];
+						++_lettersAdded;
+
+						successValue = 1;
+					}
 				}
+				++i;
 			}
-			++i;
+			++numberOfTries;
+			++_donorPicks;
 		}
-		++numberOfTries;
 
-		// Stop trying if you haven't found a match in a large number of tries (equal to _listSize)
-		// then just fill in the next space with a vowel
-		if (numberOfTries >= _listSize)
+		// Stop trying if you haven't found a match in a large number of tries (equal to the number of donor words)
+		// or the budget for this word is gone, then just fill in the next space with a vowel
+		if (_lettersAdded == nextLetterIndex)
 		{
 			_randomWord[nextLetterIndex] = generateRandomVowel();
 			++_lettersAdded;
 
 			successValue = 1;
+			++fallbacks;
 		}
 	}
 
+	if (_metrics != nullptr)
+	{
+		addMetric(_metrics->sectionLetters[section], _lettersAdded - firstLetter);
+		addMetric(_metrics->sectionFallbacks[section], fallbacks);
+	}
+
 	return successValue;
 }
 
-// Check if argument character is an alpha
-// Returns true if it is an alpha, or false if it is anything else
-bool RandomWord::checkChar(char& aChar)
+// Check if the work budget for the current word has been used up
+// Returns true if no more donor words may be examined
+bool RandomWord::budgetSpent()
 {
-	bool returnValue = false;
-
-	if ((tolower(aChar) >= 97) && (tolower(aChar) <= 122))
+	if ((_workBudget > 0) && (_donorPicks >= _workBudget))
 	{
-		returnValue = true;
+		_budgetExhausted = true;
 	}
 
-	return returnValue;
+	return _budgetExhausted;
+}
+
+// Check if argument character is an alpha
+// Returns true if it is an alpha, or false if it is anything else
+bool RandomWord::checkChar(const char& aChar)
+{
+	return isLetter(aChar);
 }
 
 // Gives index bounds for the first 1/3 of _randomWord (rounded down)
@@ -510,4 +1348,10 @@ int RandomWord::display() const
 	}
 
 	return successValue;
+}
+
+// Returns the word generated last, or nullptr if there isn't one
+const char* RandomWord::word() const
+{
+	return _randomWord;
 }
\ No newline at end of file
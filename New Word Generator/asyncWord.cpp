@@ -0,0 +1,235 @@
+#include "asyncWord.h"
+
+#ifdef RANDOM_WORD_ASYNC
+
+using namespace std;
+
+ThreadPoolExecutor::ThreadPoolExecutor(const int& threadCount)
+{
+	int	i;
+
+
+	_stopping = false;
+	for (i = 0; i < max(threadCount, 1); ++i)
+	{
+		_threads.push_back(thread(&ThreadPoolExecutor::runThread, this));
+	}
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+	size_t	i;
+
+
+	{
+		lock_guard<mutex>	hold(_queueLock);
+		_stopping = true;
+	}
+	_queueReady.notify_all();
+
+	for (i = 0; i < _threads.size(); ++i)
+	{
+		_threads[i].join();
+	}
+}
+
+// Runs work later on one of the pool's threads
+void ThreadPoolExecutor::post(function<void()> work)
+{
+	{
+		lock_guard<mutex>	hold(_queueLock);
+		_queue.push_back(move(work));
+	}
+	_queueReady.notify_one();
+}
+
+// Runs queued work until the pool stops and the queue is empty
+void ThreadPoolExecutor::runThread()
+{
+	function<void()>	work;
+
+
+	while (true)
+	{
+		{
+			unique_lock<mutex>	hold(_queueLock);
+
+			_queueReady.wait(hold, [this]() { return (_stopping || !_queue.empty()); });
+			if (_queue.empty())
+			{
+				return;
+			}
+			work = move(_queue.front());
+			_queue.pop_front();
+		}
+
+		work();
+	}
+}
+
+
+
+// Queues work for the next runPending() (safe from any thread)
+void LoopExecutor::post(function<void()> work)
+{
+	lock_guard<mutex>	hold(_queueLock);
+
+	_queue.push_back(move(work));
+}
+
+// Runs the work posted before this call, on the calling thread (call once per loop iteration)
+// Returns the number of pieces of work run
+int LoopExecutor::runPending()
+{
+	deque<function<void()>>	ready;
+	int			workRun = 0;
+
+
+	// Take the queue first, so work that posts more work can't keep this call running forever
+	{
+		lock_guard<mutex>	hold(_queueLock);
+		ready.swap(_queue);
+	}
+
+	while (!ready.empty())
+	{
+		ready.front()();
+		ready.pop_front();
+		++workRun;
+	}
+
+	return workRun;
+}
+
+// Returns the number of pieces of work waiting
+int LoopExecutor::pending()
+{
+	lock_guard<mutex>	hold(_queueLock);
+
+	return (int)_queue.size();
+}
+
+
+
+CancelSource::CancelSource() : _cancelled(false)
+{
+}
+
+// Asks every task holding this source to stop
+void CancelSource::cancel()
+{
+	_cancelled = true;
+}
+
+// Check if cancel() has been called
+bool CancelSource::cancelled() const
+{
+	return _cancelled;
+}
+
+
+
+WordStream::~WordStream()
+{
+	if (_handle)
+	{
+		_handle.destroy();
+	}
+}
+
+// Generates the next word
+// Returns false once the stream has ended (every word made, or cancelled)
+bool WordStream::next()
+{
+	if ((!_handle) || (_handle.done()))
+	{
+		return false;
+	}
+
+	_handle.resume();
+	if (_handle.promise().error)
+	{
+		rethrow_exception(_handle.promise().error);
+	}
+
+	return (!_handle.done());
+}
+
+// Returns the word made by the last next(), valid until the next call
+const char* WordStream::word() const
+{
+	return (_handle) ? _handle.promise().current : nullptr;
+}
+
+
+
+// Loads a corpus on worker, then resumes on home
+// Returns the loaded RandomWord, or nullptr if the file couldn't be used (as RandomWord displays) or cancel was cancelled (cancel may be nullptr)
+WordTask<unique_ptr<RandomWord>> loadCorpusAsync(WordExecutor& worker, WordExecutor& home, string fileName, long memoryCap, const CancelSource* cancel)
+{
+	unique_ptr<RandomWord>	corpus;
+
+
+	co_await resumeOn(worker);
+
+	// Loading can't stop part way, so check before starting and throw the result away if cancelled meanwhile
+	if ((cancel == nullptr) || (!cancel->cancelled()))
+	{
+		corpus.reset(new RandomWord(fileName, memoryCap));
+	}
+	if (((cancel != nullptr) && (cancel->cancelled())) || ((corpus) && (corpus->listSize() == 0)))
+	{
+		corpus.reset();
+	}
+
+	co_await resumeOn(home);
+
+	co_return move(corpus);
+}
+
+// Generates up to wordCount words into batch on worker with a generator borrowing corpus, then resumes on home
+// workBudget bounds each word as in RandomWord::generate(), and cancel is checked before every word
+// Returns the number of words added to batch
+WordTask<int> generateBatchAsync(WordExecutor& worker, WordExecutor& home, const RandomWord& corpus, WordBatch& batch, int wordCount, int workBudget, const CancelSource* cancel)
+{
+	int	wordsAdded = 0;
+	int	i;
+
+
+	co_await resumeOn(worker);
+
+	{
+		RandomWord	aRandomWord(&corpus, false);	// Its first word would have no budget and ignore cancel
+
+		for (i = 0; (i < wordCount) && ((cancel == nullptr) || (!cancel->cancelled())); ++i)
+		{
+			if (aRandomWord.generate(workBudget) != 0)
+			{
+				wordsAdded += batch.add(aRandomWord.word());
+			}
+		}
+	}
+
+	co_await resumeOn(home);
+
+	co_return wordsAdded;
+}
+
+// Returns a stream of up to wordCount words made on the calling thread, one per next(), with a generator borrowing corpus
+// workBudget bounds the time any one next() can take, and cancel is checked before every word
+WordStream streamWords(const RandomWord& corpus, long long wordCount, int workBudget, const CancelSource* cancel)
+{
+	RandomWord	aRandomWord(&corpus, false);	// Its first word would have no budget and ignore cancel
+	long long	i;
+
+
+	for (i = 0; (i < wordCount) && ((cancel == nullptr) || (!cancel->cancelled())); ++i)
+	{
+		if (aRandomWord.generate(workBudget) != 0)
+		{
+			co_yield aRandomWord.word();
+		}
+	}
+}
+
+#endif
\ No newline at end of file
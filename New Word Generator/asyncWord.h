@@ -0,0 +1,273 @@
+#pragma once
+#include "randomWord.h"
+#include "wordBatch.h"
+
+// The async API needs C++20 coroutines; older compilers build everything else without it
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define RANDOM_WORD_ASYNC 1
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// EXECUTORS
+// Where a task continues after co_await resumeOn(executor)
+class WordExecutor
+{
+public:
+	virtual ~WordExecutor() {}
+
+	// Runs work later on one of this executor's threads
+	virtual void post(function<void()> work) = 0;
+};
+
+// Runs posted work on its own threads
+class ThreadPoolExecutor : public WordExecutor
+{
+public:
+	// Constructor
+	// Starts threadCount threads (at least 1)
+	explicit ThreadPoolExecutor(const int& threadCount);
+	//
+	// Every thread runs runThread() on this pool, so the pool can't be copied or moved away from them
+	ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+	ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+	//
+	// Destructor
+	// Finishes the work already posted, then joins every thread
+	~ThreadPoolExecutor();
+
+	// Runs work later on one of the pool's threads
+	void post(function<void()> work) override;
+
+private:
+	vector<thread>			_threads;	// The pool's threads
+	deque<function<void()>>		_queue;		// Work waiting for a thread
+	mutex				_queueLock;	// Guards _queue and _stopping
+	condition_variable		_queueReady;	// Signalled when work is posted or the pool stops
+	bool				_stopping;	// True once the destructor has started
+
+
+
+	// Runs queued work until the pool stops and the queue is empty
+	void runThread();
+};
+
+// Holds posted work until the caller's event loop runs it
+class LoopExecutor : public WordExecutor
+{
+public:
+	// Queues work for the next runPending() (safe from any thread)
+	void post(function<void()> work) override;
+
+	// Runs the work posted before this call, on the calling thread (call once per loop iteration)
+	// Returns the number of pieces of work run
+	int runPending();
+	//
+	// Returns the number of pieces of work waiting
+	int pending();
+
+private:
+	deque<function<void()>>		_queue;		// Work waiting for runPending()
+	mutex				_queueLock;	// Guards _queue
+};
+
+
+
+// CANCELLATION
+// Shared by the caller and its tasks; a task stops at its next check once cancel() is called
+class CancelSource
+{
+public:
+	// Constructor
+	// Starts out not cancelled
+	CancelSource();
+
+	// Asks every task holding this source to stop
+	void cancel();
+	//
+	// Check if cancel() has been called
+	bool cancelled() const;
+
+private:
+	atomic<bool>	_cancelled;
+};
+
+
+
+// TASKS
+//
+// Awaitable that moves the awaiting coroutine onto executor
+struct ResumeOn
+{
+	WordExecutor&	executor;
+
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(coroutine_handle<> awaiter) const { executor.post([awaiter]() { awaiter.resume(); }); }
+	void await_resume() const noexcept {}
+};
+//
+// Returns the awaitable for co_await resumeOn(executor)
+inline ResumeOn resumeOn(WordExecutor& executor)
+{
+	return ResumeOn{ executor };
+}
+
+// A lazily started coroutine returning a T
+//
+// Inside a coroutine, co_await the task to start it and get its result. Elsewhere (the top of an
+// event loop), call start(), then take result() once ready() is true.
+template<typename T>
+class WordTask
+{
+public:
+	struct promise_type
+	{
+		T			value{};		// What the coroutine returned
+		exception_ptr		error;			// What the coroutine threw, if anything
+		coroutine_handle<>	continuation;		// The coroutine awaiting this one (none after start())
+		atomic<bool>		finished{ false };	// Set once value or error is filled in
+
+		// The result is read in order, so awaiting never misses the final resume
+		struct FinalAwaiter
+		{
+			bool await_ready() const noexcept { return false; }
+			coroutine_handle<> await_suspend(coroutine_handle<promise_type> task) noexcept
+			{
+				coroutine_handle<>	continuation = task.promise().continuation;
+
+				task.promise().finished.store(true, memory_order_release);
+				return (continuation) ? continuation : noop_coroutine();
+			}
+			void await_resume() const noexcept {}
+		};
+
+		WordTask get_return_object() { return WordTask(coroutine_handle<promise_type>::from_promise(*this)); }
+		suspend_always initial_suspend() noexcept { return {}; }
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void return_value(T result) { value = move(result); }
+		void unhandled_exception() { error = current_exception(); }
+	};
+
+	// Moving hands the coroutine to the new task; a copy would resume and destroy it a second time
+	WordTask(WordTask&& other) noexcept : _handle(other._handle), _started(other._started) { other._handle = nullptr; }
+	WordTask(const WordTask&) = delete;
+	WordTask& operator=(const WordTask&) = delete;
+	//
+	// Destructor
+	// Don't destroy a task that was started and isn't ready() yet
+	~WordTask()
+	{
+		if (_handle)
+		{
+			_handle.destroy();
+		}
+	}
+
+	// Awaiting starts the task and resumes the awaiter with its result
+	bool await_ready() const noexcept { return false; }
+	coroutine_handle<> await_suspend(coroutine_handle<> awaiter)
+	{
+		_started = true;
+		_handle.promise().continuation = awaiter;
+		return _handle;
+	}
+	T await_resume() { return result(); }
+
+	// Runs the task on the calling thread until its first co_await
+	void start()
+	{
+		if (!_started)
+		{
+			_started = true;
+			_handle.resume();
+		}
+	}
+	//
+	// Check if the task has finished
+	bool ready() const
+	{
+		return _handle.promise().finished.load(memory_order_acquire);
+	}
+	//
+	// Returns what the task returned, or rethrows what it threw (only once ready())
+	T result()
+	{
+		if (_handle.promise().error)
+		{
+			rethrow_exception(_handle.promise().error);
+		}
+		return move(_handle.promise().value);
+	}
+
+private:
+	coroutine_handle<promise_type>	_handle;	// The coroutine
+	bool				_started;	// True once start() or co_await has resumed it
+
+	explicit WordTask(coroutine_handle<promise_type> handle) : _handle(handle), _started(false) {}
+};
+
+// A lazy sequence of words, each generated when the caller asks for it
+class WordStream
+{
+public:
+	struct promise_type
+	{
+		const char*	current = nullptr;	// The word yielded last
+		exception_ptr	error;			// What the coroutine threw, if anything
+
+		WordStream get_return_object() { return WordStream(coroutine_handle<promise_type>::from_promise(*this)); }
+		suspend_always initial_suspend() noexcept { return {}; }
+		suspend_always final_suspend() noexcept { return {}; }
+		suspend_always yield_value(const char* word) noexcept { current = word; return {}; }
+		void return_void() {}
+		void unhandled_exception() { error = current_exception(); }
+	};
+
+	// Moving hands the coroutine to the new stream, which alone may call next() on it from then on
+	WordStream(WordStream&& other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+	WordStream(const WordStream&) = delete;
+	WordStream& operator=(const WordStream&) = delete;
+	//
+	// Destructor
+	~WordStream();
+
+	// Generates the next word
+	// Returns false once the stream has ended (every word made, or cancelled)
+	bool next();
+	//
+	// Returns the word made by the last next(), valid until the next call
+	const char* word() const;
+
+private:
+	coroutine_handle<promise_type>	_handle;	// The coroutine
+
+	explicit WordStream(coroutine_handle<promise_type> handle) : _handle(handle) {}
+};
+
+
+
+// ASYNC GENERATION
+// Parameters that are references must outlive the task; everything else is copied into it
+//
+// Loads a corpus on worker, then resumes on home
+// Returns the loaded RandomWord, or nullptr if the file couldn't be used (as RandomWord displays) or cancel was cancelled (cancel may be nullptr)
+WordTask<unique_ptr<RandomWord>> loadCorpusAsync(WordExecutor& worker, WordExecutor& home, string fileName, long memoryCap, const CancelSource* cancel);
+//
+// Generates up to wordCount words into batch on worker with a generator borrowing corpus, then resumes on home
+// workBudget bounds each word as in RandomWord::generate(), and cancel is checked before every word
+// Returns the number of words added to batch
+WordTask<int> generateBatchAsync(WordExecutor& worker, WordExecutor& home, const RandomWord& corpus, WordBatch& batch, int wordCount, int workBudget, const CancelSource* cancel);
+//
+// Returns a stream of up to wordCount words made on the calling thread, one per next(), with a generator borrowing corpus
+// workBudget bounds the time any one next() can take, and cancel is checked before every word
+WordStream streamWords(const RandomWord& corpus, long long wordCount, int workBudget, const CancelSource* cancel);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "selfTest.h"
+#include "asyncWord.h"
+#include <chrono>
+
+using namespace std;
+
+#ifdef RANDOM_WORD_ASYNC
+
+// ASYNC TEST SETTINGS
+const int ASYNC_TEST_SECONDS = 30;		// A task not ready after this long counts as hung
+const int ASYNC_TEST_BATCH = 1000;		// Words asked of generateBatchAsync()
+
+
+
+// Starts task and drains home, as an event loop would, until the task is ready
+// Returns true if it became ready within ASYNC_TEST_SECONDS
+template<typename T>
+static bool runUntilReady(WordTask<T>& task, LoopExecutor& home)
+{
+	chrono::steady_clock::time_point	giveUp = chrono::steady_clock::now() + chrono::seconds(ASYNC_TEST_SECONDS);
+
+
+	task.start();
+	while ((!task.ready()) && (chrono::steady_clock::now() < giveUp))
+	{
+		if (home.runPending() == 0)
+		{
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+	}
+
+	return task.ready();
+}
+
+// Awaits loadCorpusAsync() from inside a coroutine, as a caller's own task would
+// Returns true if the load resumed on homeThread
+static WordTask<bool> loadFromTask(WordExecutor& worker, WordExecutor& home, string fileName, unique_ptr<RandomWord>& corpus, thread::id homeThread)
+{
+	corpus = co_await loadCorpusAsync(worker, home, fileName, 0, nullptr);
+
+	co_return (this_thread::get_id() == homeThread);
+}
+
+// Checks loading, including a missing file and a cancelled load
+static void testLoad(ThreadPoolExecutor& worker, LoopExecutor& home, const string& fileName, unique_ptr<RandomWord>& corpus)
+{
+	WordTask<bool>				loaded = loadFromTask(worker, home, fileName, corpus, this_thread::get_id());
+	WordTask<unique_ptr<RandomWord>>	missing = loadCorpusAsync(worker, home, selfTestPath("missing.txt"), 0, nullptr);
+	CancelSource				cancel;
+	WordTask<unique_ptr<RandomWord>>	cancelled = loadCorpusAsync(worker, home, fileName, 0, &cancel);
+
+
+	selfCheck((runUntilReady(loaded, home)) && (loaded.result()) && (corpus) && (corpus->listSize() == SELF_TEST_WORDS),
+		"an awaited load gets the corpus and resumes on the home executor");
+	selfCheck((runUntilReady(missing, home)) && (missing.result() == nullptr), "a missing corpus file comes back as nullptr");
+
+	cancel.cancel();
+	selfCheck((runUntilReady(cancelled, home)) && (cancelled.result() == nullptr), "a cancelled load comes back as nullptr");
+}
+
+// Checks that a batch is filled on the pool, and that a cancelled batch stops
+static void testBatches(ThreadPoolExecutor& worker, LoopExecutor& home, const RandomWord& corpus)
+{
+	WordBatch		batch(ASYNC_TEST_BATCH, LARGEST_WORD);
+	WordBatch		stoppedBatch(ASYNC_TEST_BATCH, LARGEST_WORD);
+	CancelSource		cancel;
+	WordTask<int>		filled = generateBatchAsync(worker, home, corpus, batch, ASYNC_TEST_BATCH, 0, nullptr);
+	WordTask<int>		stopped = generateBatchAsync(worker, home, corpus, stoppedBatch, ASYNC_TEST_BATCH, 0, &cancel);
+	char			bufferWord[LARGEST_WORD + 1];
+	bool			words = true;
+	int			i;
+
+
+	selfCheck((runUntilReady(filled, home)) && (filled.result() == ASYNC_TEST_BATCH) && (batch.size() == ASYNC_TEST_BATCH),
+		"generateBatchAsync() fills the batch");
+	for (i = 0; i < batch.size(); ++i)
+	{
+		batch.copyWord(i, bufferWord);
+		words &= (strlen(bufferWord) >= SMALLEST_WORD);
+	}
+	selfCheck(words, "every batched word has letters");
+
+	cancel.cancel();
+	selfCheck((runUntilReady(stopped, home)) && (stopped.result() == 0) && (stoppedBatch.size() == 0), "a cancelled batch makes no words");
+}
+
+// Checks that a stream yields the words asked for, and ends once cancelled without generating another
+static void testStream(const RandomWord& corpus)
+{
+	WordStream	whole = streamWords(corpus, 50, 0, nullptr);
+	CancelSource	cancel;
+	WordStream	stopped = streamWords(corpus, 50, 0, &cancel);
+	WordStream	early = streamWords(corpus, 50, 1, &cancel);	// Not started until cancel is cancelled
+	RandomWord	borrower(&corpus, false);
+	int		wholeWords = 0;
+	int		stoppedWords = 0;
+	bool		words = true;
+
+
+	while (whole.next())
+	{
+		words &= (strlen(whole.word()) >= SMALLEST_WORD);
+		++wholeWords;
+	}
+	while (stopped.next())
+	{
+		if (++stoppedWords == 10)
+		{
+			cancel.cancel();
+		}
+	}
+
+	selfCheck((wholeWords == 50) && (words), "a stream yields every word asked for");
+	selfCheck((stoppedWords == 10) && (!stopped.next()), "a cancelled stream ends at its next word");
+
+	// Cancelled before it starts, a stream's generator is made without a first word, so nothing at all is generated
+	selfCheck((borrower.word() == nullptr) && (borrower.donorPicks() == 0), "a generator made without a first word generates nothing");
+	selfCheck((!early.next()) && (early.word() == nullptr), "a stream cancelled before its first next() yields no word");
+}
+
+#endif
+
+
+
+// Tasks, streams, executors, and cancellation of the C++20 async API (nothing without it)
+void testAsyncWord()
+{
+#ifdef RANDOM_WORD_ASYNC
+	string			fileName = selfTestPath("async.txt");
+	unique_ptr<RandomWord>	corpus;
+
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the async corpus"))
+	{
+		ThreadPoolExecutor	worker(2);
+		LoopExecutor		home;
+
+		testLoad(worker, home, fileName, corpus);
+		if (corpus)
+		{
+			testBatches(worker, home, *corpus);
+			testStream(*corpus);
+		}
+	}
+	remove(fileName.c_str());
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "batchGenerator.h"
+#include <cmath>
+
+using namespace std;
+
+BatchGenerator::BatchGenerator(const RandomWord& corpus)
+{
+	const SuccessorIndex&	index = corpus.successorIndex();
+	int			counts[INDEX_SUCCESSORS];
+	int			total;
+	double			fallbackChance;		// Chance that corpus.listSize() random donors all have no successor
+	int			section;
+	int			letter;
+	int			slot;
+
+
+	for (slot = 0; slot < INDEX_SUCCESSORS; ++slot)
+	{
+		_outcomeChar[slot] = (slot < INDEX_LETTERS) ? ('a' + slot) : ('A' + (slot - INDEX_LETTERS));
+	}
+
+	for (section = 0; section < INDEX_SECTIONS; ++section)
+	{
+		for (letter = 0; letter < INDEX_LETTERS; ++letter)
+		{
+			for (slot = 0; slot < INDEX_SUCCESSORS; ++slot)
+			{
+				counts[slot] = index.count(section, 'a' + letter, slot);
+			}
+			total = index.total(section, 'a' + letter);
+
+			// fillSection() tries _listSize donors, each with a total / _listSize chance of having a successor
+			if (total <= 0)
+			{
+				fallbackChance = 1;
+			}
+			else if (total >= corpus.listSize())
+			{
+				fallbackChance = 0;
+			}
+			else
+			{
+				fallbackChance = exp(corpus.listSize() * log1p(-(double)total / corpus.listSize()));
+			}
+
+			buildAliasRow(counts, total, fallbackChance, _rows[section][letter]);
+		}
+	}
+
+	_lengths = nullptr;
+	_blocklist = nullptr;
+	_metrics = nullptr;
+	seed(time(NULL) ^ (unsigned long long)this);
+}
+
+
+
+// Restarts every word's random number sequence from seedValue
+void BatchGenerator::seed(const unsigned long long& seedValue)
+{
+	_seed = seedValue;
+	_rngStates.clear();
+}
+
+// Draws word lengths from lengths (nullptr for SMALLEST_WORD to LARGEST_WORD), see RandomWord::setLengthDistribution()
+void BatchGenerator::setLengthDistribution(const LengthDistribution* lengths)
+{
+	_lengths = ((lengths != nullptr) && (!lengths->empty())) ? lengths : nullptr;
+}
+
+// Drops words blocklist blocks (nullptr screens nothing), so a batch may come back with fewer words
+void BatchGenerator::setBlocklist(const Blocklist* blocklist)
+{
+	_blocklist = blocklist;
+}
+
+// Counts every letter drawn for a third of a word, and every vowel fallback, into metrics (nullptr counts nothing)
+// metrics must belong to the thread calling generate()
+void BatchGenerator::setMetrics(ThreadMetrics* metrics)
+{
+	_metrics = metrics;
+}
+
+
+
+// Empties batch and fills it with up to wordCount new words (never more than batch.capacity())
+// Returns the number of words in batch, or 0 if batch.maxLength() is shorter than the longest possible word
+int BatchGenerator::generate(WordBatch& batch, const int& wordCount)
+{
+	const int		words = min(wordCount, batch.capacity());
+	const int		longest = (_lengths != nullptr) ? _lengths->largest() : LARGEST_WORD;
+	unsigned char*		lengths = batch.lengths();
+	unsigned long long*	states;
+	const char*		before;		// Row of the letters before position
+	char*			letters;	// Row being filled in
+	char			wordBuffer[MAX_CHAR];
+	long long		sectionLetters[INDEX_SECTIONS] = { 0 };		// Tallied here and added to _metrics once per batch
+	long long		sectionFallbacks[INDEX_SECTIONS] = { 0 };
+	const AliasRow*		row;
+	int			position;
+	int			length;
+	int			third;
+	int			section;
+	int			column;
+	int			w;
+
+
+	batch.clear();
+	if ((longest > batch.maxLength()) || (words <= 0))
+	{
+		return 0;
+	}
+
+	growStates(words);
+	states = _rngStates.data();
+
+	// Lengths and first letters
+	letters = batch.letters(0);
+	for (w = 0; w < words; ++w)
+	{
+		lengths[w] = (_lengths != nullptr) ? _lengths->sample(nextRandom(states[w])) : (SMALLEST_WORD + sampleBelow(nextRandom(states[w]), LARGEST_WORD - SMALLEST_WORD + 1));
+		letters[w] = sampleLetter(nextRandom(states[w]));
+	}
+
+	// Every later position of every word, one row at a time
+	for (position = 1; position < batch.maxLength(); ++position)
+	{
+		before = batch.letters(position - 1);
+		letters = batch.letters(position);
+
+		for (w = 0; w < words; ++w)
+		{
+			length = lengths[w];
+
+			if (position >= length)
+			{
+				letters[w] = '\0';
+			}
+			else if (length == 2)
+			{
+				// The same as RandomWord::generateTwoLetterWord()
+				letters[w] = sampleOpposite(before[w], nextRandom(states[w]));
+			}
+			else
+			{
+				// The same thirds as RandomWord::firstThird(), middleThird() and lastThird()
+				third = length / 3;
+				section = (position < third) ? 0 : ((position < length - third) ? 1 : 2);
+				row = &_rows[section][letterIndex(before[w])];
+
+				column = sampleBelow(nextRandom(states[w]), BATCH_OUTCOMES);
+				if (nextRandom(states[w]) >= row->threshold[column])
+				{
+					column = row->alias[column];
+				}
+
+				letters[w] = (column == BATCH_FALLBACK) ? sampleVowel(nextRandom(states[w])) : _outcomeChar[column];
+				++sectionLetters[section];
+				sectionFallbacks[section] += (column == BATCH_FALLBACK);
+			}
+		}
+	}
+
+	batch.setSize(words);
+
+	if (_metrics != nullptr)
+	{
+		for (section = 0; section < INDEX_SECTIONS; ++section)
+		{
+			addMetric(_metrics->sectionLetters[section], sectionLetters[section]);
+			addMetric(_metrics->sectionFallbacks[section], sectionFallbacks[section]);
+		}
+	}
+
+	// Drop blocked words, which leaves the same words RandomWord::generate() would settle on
+	if ((_blocklist != nullptr) && (_blocklist->patternCount() > 0))
+	{
+		_keep.resize(words);
+		for (w = 0; w < words; ++w)
+		{
+			batch.copyWord(w, wordBuffer);
+			_keep[w] = (!_blocklist->blocks(wordBuffer));
+		}
+		batch.keepWhere(_keep.data());
+	}
+
+	return batch.size();
+}
+
+
+
+// Fills row from one row of successor counts and the chance of falling back to a vowel
+void BatchGenerator::buildAliasRow(const int counts[INDEX_SUCCESSORS], const int& total, const double& fallbackChance, AliasRow& row)
+{
+	double		scaled[BATCH_OUTCOMES];		// Each outcome's chance times BATCH_OUTCOMES
+	int		small[BATCH_OUTCOMES];		// Outcomes with scaled below 1
+	int		large[BATCH_OUTCOMES];		// Outcomes with scaled of 1 or more
+	int		smallCount = 0;
+	int		largeCount = 0;
+	int		less;
+	int		more;
+	int		i;
+
+
+	for (i = 0; i < INDEX_SUCCESSORS; ++i)
+	{
+		scaled[i] = (total > 0) ? ((1 - fallbackChance) * counts[i] / total * BATCH_OUTCOMES) : 0;
+	}
+	scaled[BATCH_FALLBACK] = fallbackChance * BATCH_OUTCOMES;
+
+	for (i = 0; i < BATCH_OUTCOMES; ++i)
+	{
+		if (scaled[i] < 1)
+		{
+			small[smallCount++] = i;
+		}
+		else
+		{
+			large[largeCount++] = i;
+		}
+	}
+
+	// Vose's method: pair each short column with part of a tall one
+	while ((smallCount > 0) && (largeCount > 0))
+	{
+		less = small[--smallCount];
+		more = large[largeCount - 1];
+
+		row.threshold[less] = (unsigned int)(scaled[less] * 4294967296.0);
+		row.alias[less] = (unsigned char)more;
+
+		scaled[more] -= 1 - scaled[less];
+		if (scaled[more] < 1)
+		{
+			--largeCount;
+			small[smallCount++] = more;
+		}
+	}
+
+	// What is left is full up to rounding, so it always keeps its own outcome
+	while (largeCount > 0)
+	{
+		more = large[--largeCount];
+		row.threshold[more] = 0xFFFFFFFFu;
+		row.alias[more] = (unsigned char)more;
+	}
+	while (smallCount > 0)
+	{
+		less = small[--smallCount];
+		row.threshold[less] = 0xFFFFFFFFu;
+		row.alias[less] = (unsigned char)less;
+	}
+}
+
+// Makes sure there is a random number state for every word up to wordCount
+void BatchGenerator::growStates(const int& wordCount)
+{
+	unsigned long long	state;
+	size_t			w;
+
+
+	for (w = _rngStates.size(); w < (size_t)wordCount; ++w)
+	{
+		// splitmix64 of (seed, word), the same spreading RandomWord::seed() uses
+		state = _seed + 0x9E3779B97F4A7C15ULL * (w + 1);
+		state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		state = (state ^ (state >> 27)) * 0x94D049BB133111EBULL;
+		state ^= state >> 31;
+		_rngStates.push_back((state != 0) ? state : 1);
+	}
+}
+
+// Returns the next 32 random bits of state (xorshift64*)
+unsigned int BatchGenerator::nextRandom(unsigned long long& state)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+
+	return (unsigned int)((state * 0x2545F4914F6CDD1DULL) >> 32);
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+#include "randomWord.h"
+#include "wordBatch.h"
+#include <vector>
+
+
+// BATCH GENERATOR SETTINGS
+const int BATCH_OUTCOMES = INDEX_SUCCESSORS + 1;	// Every successor slot, then BATCH_FALLBACK
+const int BATCH_FALLBACK = INDEX_SUCCESSORS;		// Outcome standing for fillSection() giving up and adding a vowel
+
+
+// Generates a whole WordBatch at once, advancing every word in lockstep
+//
+// Each letter is drawn straight from the successor counts instead of by searching donor words:
+// fillSection() takes the successor of the first random donor that has one, so each successor comes
+// up in proportion to its SuccessorIndex count, and the vowel fallback comes up with the chance that
+// _listSize random donors all have none. Those odds are turned into one alias table per
+// (section, letter), so a letter costs two random numbers and two small table lookups whatever the
+// donor list holds.
+//
+// Position k of every word is generated before position k + 1 of any, reading and writing whole
+// WordBatch rows, and each word has its own random number state kept in an array beside the batch.
+// The work budget of RandomWord::generate() doesn't apply, since no donor words are examined.
+class BatchGenerator
+{
+public:
+	// Constructor
+	// Builds the alias tables from corpus, which is only read while constructing
+	explicit BatchGenerator(const RandomWord& corpus);
+
+	// Restarts every word's random number sequence from seedValue
+	void seed(const unsigned long long& seedValue);
+	//
+	// Draws word lengths from lengths (nullptr for SMALLEST_WORD to LARGEST_WORD), see RandomWord::setLengthDistribution()
+	void setLengthDistribution(const LengthDistribution* lengths);
+	//
+	// Drops words blocklist blocks (nullptr screens nothing), so a batch may come back with fewer words
+	void setBlocklist(const Blocklist* blocklist);
+	//
+	// Counts every letter drawn for a third of a word, and every vowel fallback, into metrics (nullptr counts nothing)
+	// metrics must belong to the thread calling generate()
+	void setMetrics(ThreadMetrics* metrics);
+
+	// Empties batch and fills it with up to wordCount new words (never more than batch.capacity())
+	// Returns the number of words in batch, or 0 if batch.maxLength() is shorter than the longest possible word
+	int generate(WordBatch& batch, const int& wordCount);
+
+private:
+	// How to draw the letter after one letter in one section, as a Vose alias table over BATCH_OUTCOMES
+	struct AliasRow
+	{
+		unsigned int	threshold[BATCH_OUTCOMES];	// A second draw below this keeps the column's own outcome
+		unsigned char	alias[BATCH_OUTCOMES];		// The outcome taken otherwise
+	};
+
+	AliasRow			_rows[INDEX_SECTIONS][INDEX_LETTERS];	// One table per (section, letter)
+	char				_outcomeChar[INDEX_SUCCESSORS];		// The letter each successor slot stands for
+	vector<unsigned long long>	_rngStates;				// Each word's random number state (xorshift64*)
+	vector<unsigned char>		_keep;					// Scratch for blocklist screening
+	unsigned long long		_seed;					// Seed the states were last derived from
+	const LengthDistribution*	_lengths;				// Where lengths are drawn from (nullptr for the default)
+	const Blocklist*		_blocklist;				// Banned substrings screened out (nullptr for none)
+	ThreadMetrics*			_metrics;				// Where letters and fallbacks are counted (nullptr for nowhere)
+
+
+
+	// Fills row from one row of successor counts and the chance of falling back to a vowel
+	static void buildAliasRow(const int counts[INDEX_SUCCESSORS], const int& total, const double& fallbackChance, AliasRow& row);
+	//
+	// Makes sure there is a random number state for every word up to wordCount
+	void growStates(const int& wordCount);
+	//
+	// Returns the next 32 random bits of state (xorshift64*)
+	static unsigned int nextRandom(unsigned long long& state);
+};
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "selfTest.h"
+#include "batchGenerator.h"
+#include <cmath>
+
+using namespace std;
+
+// BATCH GENERATOR TEST SETTINGS
+const int BATCH_TEST_WORDS = 4096;		// Words per batch
+const int BATCH_TEST_BATCHES = 60;		// Batches drawn when tallying letters
+const double BATCH_TEST_DEVIATIONS = 6;		// Standard deviations a tally may stray from its expected count
+
+
+
+// Returns the share of letters after letter in section that should be slot, the way fillSection() picks them
+static double expectedShare(const RandomWord& corpus, const int& section, const char& letter, const int& slot)
+{
+	const SuccessorIndex&	index = corpus.successorIndex();
+	double			total = index.total(section, letter);
+	double			fallbackChance;
+	bool			vowel = (slot < INDEX_LETTERS) && (isVowel((char)('a' + slot)));
+
+
+	fallbackChance = (total <= 0) ? 1 : ((total >= corpus.listSize()) ? 0 : pow(1 - total / corpus.listSize(), corpus.listSize()));
+
+	return ((total > 0) ? ((1 - fallbackChance) * index.count(section, letter, slot) / total) : 0) + (vowel ? (fallbackChance / VOWEL_COUNT) : 0);
+}
+
+// Checks that the second letter of three-letter words (the middle third) follows the successor counts of the first
+static void testAliasSampling(const RandomWord& corpus)
+{
+	BatchGenerator		generator(corpus);
+	LengthDistribution	lengths;
+	WordBatch		batch(BATCH_TEST_WORDS, LARGEST_WORD);
+	long long		tallies[INDEX_LETTERS][INDEX_LETTERS] = { { 0 } };	// [first letter][second letter]
+	long long		drawn;
+	double			expected;
+	bool			possible = true;
+	bool			close = true;
+	int			before;
+	int			slot;
+	int			i;
+	int			w;
+
+
+	lengths.setUniform(3, 3);
+	generator.setLengthDistribution(&lengths);
+	generator.seed(SELF_TEST_SEED);
+	for (i = 0; i < BATCH_TEST_BATCHES; ++i)
+	{
+		generator.generate(batch, BATCH_TEST_WORDS);
+		for (w = 0; w < batch.size(); ++w)
+		{
+			++tallies[letterIndex(batch.letters(0)[w])][letterIndex(batch.letters(1)[w])];
+		}
+	}
+
+	for (before = 0; before < INDEX_LETTERS; ++before)
+	{
+		drawn = 0;
+		for (slot = 0; slot < INDEX_LETTERS; ++slot)
+		{
+			drawn += tallies[before][slot];
+		}
+		for (slot = 0; slot < INDEX_LETTERS; ++slot)
+		{
+			expected = expectedShare(corpus, 1, (char)('a' + before), slot);
+			possible &= (expected > 0) || (tallies[before][slot] == 0);
+			close &= (fabs(tallies[before][slot] - (drawn * expected)) <= (BATCH_TEST_DEVIATIONS * sqrt(drawn * expected * (1 - expected))) + 1);
+		}
+	}
+
+	selfCheck(possible, "the batch generator never draws a letter no donor supplies");
+	selfCheck(close, "the batch generator draws each letter in proportion to its successor count");
+}
+
+// Checks lengths, reseeding, a short batch buffer, and blocklist screening
+static void testBatchOptions(const RandomWord& corpus)
+{
+	BatchGenerator		generator(corpus);
+	LengthDistribution	lengths;
+	Blocklist		blocklist;
+	WordBatch		first(BATCH_TEST_WORDS, LARGEST_WORD);
+	WordBatch		second(BATCH_TEST_WORDS, LARGEST_WORD);
+	WordBatch		shortBatch(16, 4);
+	char			bufferWord[LARGEST_WORD + 1];
+	char			secondWord[LARGEST_WORD + 1];
+	bool			sized = true;
+	bool			repeated = true;
+	bool			screened = true;
+	int			w;
+
+
+	lengths.setUniform(5, 7);
+	generator.setLengthDistribution(&lengths);
+	generator.seed(SELF_TEST_SEED);
+	generator.generate(first, BATCH_TEST_WORDS);
+	generator.seed(SELF_TEST_SEED);
+	generator.generate(second, BATCH_TEST_WORDS);
+	for (w = 0; w < first.size(); ++w)
+	{
+		first.copyWord(w, bufferWord);
+		second.copyWord(w, secondWord);
+		sized &= (strlen(bufferWord) >= 5) && (strlen(bufferWord) <= 7);
+		repeated &= (strcmp(bufferWord, secondWord) == 0);
+	}
+	selfCheck((first.size() == BATCH_TEST_WORDS) && (sized), "every batched word has a length from the distribution");
+	selfCheck((second.size() == first.size()) && (repeated), "the same seed makes the same batch");
+	selfCheck(generator.generate(shortBatch, 16) == 0, "a batch too short for the longest length is refused");
+
+	blocklist.addPattern("a");
+	blocklist.compile();
+	generator.setBlocklist(&blocklist);
+	generator.generate(first, BATCH_TEST_WORDS);
+	for (w = 0; w < first.size(); ++w)
+	{
+		first.copyWord(w, bufferWord);
+		screened &= (strchr(bufferWord, 'a') == nullptr);
+	}
+	selfCheck((first.size() > 0) && (first.size() < BATCH_TEST_WORDS) && (screened), "blocked words are dropped from the batch");
+}
+
+
+
+// Alias table sampling and options of the batch generator
+void testBatchGenerator()
+{
+	string	fileName = selfTestPath("batch.txt");
+
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the batch corpus"))
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		testAliasSampling(aRandomWord);
+		testBatchOptions(aRandomWord);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "blocklist.h"
+
+using namespace std;
+
+Blocklist::Blocklist()
+{
+	_patternCount = 0;
+	_compiled = false;
+
+	// State 0 is the root, which matches nothing
+	addState();
+	compile();
+}
+
+
+
+// Adds every line of fileName as a pattern and compiles the automaton
+// Returns the number of patterns loaded, or -1 if the file can't open
+int Blocklist::load(const string& fileName)
+{
+	ifstream	in;
+	char		bufferPattern[MAX_CHAR];
+	int		patternsLoaded = 0;
+
+
+	in.open(fileName);
+	if (!in)
+	{
+		cerr << "Cannot read from " << fileName << endl;
+		return -1;
+	}
+
+	// addPattern() skips empty lines
+	while (readLine(in, bufferPattern))
+	{
+		patternsLoaded += addPattern(bufferPattern);
+	}
+	in.close();
+
+	compile();
+
+	return patternsLoaded;
+}
+
+// Adds a banned substring (call compile() once all patterns are added)
+// Returns 0 if the pattern is empty, 1 for success
+int Blocklist::addPattern(const char pattern[])
+{
+	int	state = 0;
+	int	next;
+	int	i;
+
+
+	if (pattern[0] == '\0')
+	{
+		return 0;
+	}
+
+	_compiled = false;
+
+	// Walk the trie, adding states for the part of the pattern that isn't there yet
+	for (i = 0; pattern[i] != '\0'; ++i)
+	{
+		next = _trie[state * BLOCKLIST_ALPHABET + letterIndex(pattern[i])];
+		if (next == -1)
+		{
+			next = addState();
+			_trie[state * BLOCKLIST_ALPHABET + letterIndex(pattern[i])] = next;
+		}
+		state = next;
+	}
+	_patternEnds[state] = 1;
+	++_patternCount;
+
+	return 1;
+}
+
+// Fills in the failure transitions so every state has a next state for every symbol
+// Returns 0 for failure, 1 for success
+int Blocklist::compile()
+{
+	vector<int>	failure(_patternEnds.size(), 0);	// Longest proper suffix of each state that is also a trie state
+	vector<int>	queue;				// States in breadth-first order
+	size_t		head = 0;
+	int		state;
+	int		symbol;
+	int		child;
+
+
+	if (_compiled)
+	{
+		return 1;
+	}
+
+	// Start from the bare trie, then fill in every missing transition
+	_transitions = _trie;
+	_accepting = _patternEnds;
+
+	// The root's missing transitions loop back to the root
+	for (symbol = 0; symbol < BLOCKLIST_ALPHABET; ++symbol)
+	{
+		child = _transitions[symbol];
+		if (child == -1)
+		{
+			_transitions[symbol] = 0;
+		}
+		else
+		{
+			failure[child] = 0;
+			queue.push_back(child);
+		}
+	}
+
+	// Every other state borrows its missing transitions from its failure state, which is
+	// always shallower and so already complete
+	while (head < queue.size())
+	{
+		state = queue[head++];
+		_accepting[state] |= _accepting[failure[state]];
+
+		for (symbol = 0; symbol < BLOCKLIST_ALPHABET; ++symbol)
+		{
+			child = _transitions[state * BLOCKLIST_ALPHABET + symbol];
+			if (child == -1)
+			{
+				_transitions[state * BLOCKLIST_ALPHABET + symbol] = _transitions[failure[state] * BLOCKLIST_ALPHABET + symbol];
+			}
+			else
+			{
+				failure[child] = _transitions[failure[state] * BLOCKLIST_ALPHABET + symbol];
+				queue.push_back(child);
+			}
+		}
+	}
+
+	_compiled = true;
+
+	return 1;
+}
+
+
+
+// Check if word contains any pattern
+// Returns true if the word should be rejected
+bool Blocklist::blocks(const char word[]) const
+{
+	const int*	transitions = _transitions.data();
+	const char*	accepting = _accepting.data();
+	int		state = 0;
+	int		i;
+
+
+	if (_patternCount == 0)
+	{
+		return false;
+	}
+
+	for (i = 0; word[i] != '\0'; ++i)
+	{
+		state = transitions[state * BLOCKLIST_ALPHABET + letterIndex(word[i])];
+		if (accepting[state])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Returns the number of patterns added
+int Blocklist::patternCount() const
+{
+	return _patternCount;
+}
+
+// Returns the bytes held by the automaton
+long Blocklist::memoryBytes() const
+{
+	return (long)(_transitions.size() * sizeof(int) + _accepting.size());
+}
+
+
+
+// Adds a state with no transitions
+// Returns the new state
+int Blocklist::addState()
+{
+	_trie.insert(_trie.end(), BLOCKLIST_ALPHABET, -1);
+	_patternEnds.push_back(0);
+
+	return (int)_patternEnds.size() - 1;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+#include "utilities.h"
+#include "letterSampler.h"
+#include <vector>
+
+
+// BLOCKLIST SETTINGS
+// Letters are matched without regard to case, every other char shares one symbol
+const int BLOCKLIST_ALPHABET = LETTER_COUNT + 1;	// letterIndex() of each char: 'a'-'z' without regard to case, then LETTER_NONE for anything else
+const int BLOCKLIST_RETRIES = 100;	// Most replacement words RandomWord::generate() tries before giving up on a blocked word
+
+
+// Screens words for any of a list of banned substrings
+//
+// The patterns are compiled into an Aho-Corasick automaton whose transitions are stored as one
+// dense table of BLOCKLIST_ALPHABET next states per state, so screening a word is a single
+// table lookup per char with no backtracking. blocks() keeps no state of its own, so threads can
+// screen with one Blocklist at the same time as long as no pattern is added while they do.
+class Blocklist
+{
+public:
+	// Constructor
+	// Starts with no patterns, blocking nothing
+	Blocklist();
+
+	// Adds every line of fileName as a pattern and compiles the automaton
+	// Returns the number of patterns loaded, or -1 if the file can't open
+	int load(const string& fileName);
+	//
+	// Adds a banned substring (call compile() once all patterns are added)
+	// Returns 0 if the pattern is empty, 1 for success
+	int addPattern(const char pattern[]);
+	//
+	// Fills in the failure transitions so every state has a next state for every symbol
+	// Returns 0 for failure, 1 for success
+	int compile();
+
+	// Check if word contains any pattern
+	// Returns true if the word should be rejected
+	bool blocks(const char word[]) const;
+
+	// Returns the number of patterns added
+	int patternCount() const;
+	//
+	// Returns the bytes held by the automaton
+	long memoryBytes() const;
+
+private:
+	vector<int>	_trie;		// Child of (state * BLOCKLIST_ALPHABET + symbol) in the pattern trie, -1 for none
+	vector<char>	_patternEnds;	// 1 if a pattern ends at the trie state
+	vector<int>	_transitions;	// Next state for (state * BLOCKLIST_ALPHABET + symbol), filled in by compile()
+	vector<char>	_accepting;	// 1 if reaching the state means some pattern has been matched, filled in by compile()
+	int		_patternCount;	// Number of patterns added
+	bool		_compiled;	// True once compile() has filled in every transition
+
+
+
+	// Adds a state with no transitions
+	// Returns the new state
+	int addState();
+};
\ No newline at end of file
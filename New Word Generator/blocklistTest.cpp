@@ -0,0 +1,99 @@
+#include "selfTest.h"
+#include "randomWord.h"
+
+using namespace std;
+
+// Checks matching on patterns that overlap, which only the failure transitions find
+static void testMatching()
+{
+	Blocklist	blocklist;
+
+
+	blocklist.addPattern("he");
+	blocklist.addPattern("she");
+	blocklist.addPattern("hers");
+	blocklist.addPattern("abcd");
+	blocklist.addPattern("bce");
+	blocklist.compile();
+
+	selfCheck(blocklist.patternCount() == 5, "every pattern is counted");
+	selfCheck((blocklist.blocks("ushers")) && (blocklist.blocks("SHE")) && (blocklist.blocks("xhex")), "a pattern is found anywhere in a word, in any case");
+	selfCheck(blocklist.blocks("abce"), "a pattern starting inside a partial match of another is found");
+	selfCheck((!blocklist.blocks("abc")) && (!blocklist.blocks("hsr")) && (!blocklist.blocks("")), "words without a pattern pass");
+}
+
+// Checks that a pattern file may hold empty lines and CRLF line endings
+static void testLoad()
+{
+	string		fileName = selfTestPath("blocklist.txt");
+	ofstream	out(fileName);
+	Blocklist	blocklist;
+	Blocklist	crlfBlocklist;
+	int		loaded;
+
+
+	out << "zz\n\nqq\n\n";
+	out.close();
+	loaded = blocklist.load(fileName);
+	remove(fileName.c_str());
+
+	selfCheck((loaded == 2) && (blocklist.blocks("aqqa")) && (blocklist.blocks("zz")) && (!blocklist.blocks("zq")),
+		"a pattern file with empty lines loads every pattern");
+	selfCheck(blocklist.load(selfTestPath("missing.txt")) == -1, "a missing pattern file is reported");
+
+	// Saved with Windows line endings the patterns must not end in '\r', which would block nothing
+	out.open(fileName, ios::binary);
+	out << "a\r\ne\r\n\r\ni\r\no\r\nu";
+	out.close();
+	loaded = crlfBlocklist.load(fileName);
+	remove(fileName.c_str());
+
+	selfCheck((loaded == 5) && (crlfBlocklist.blocks("at")) && (crlfBlocklist.blocks("fukohofa")) && (crlfBlocklist.blocks("u"))
+		&& (!crlfBlocklist.blocks("zzz")), "a pattern file with CRLF line endings blocks its patterns");
+}
+
+// Checks that a generator never hands out a blocked word
+static void testScreening(RandomWord& aRandomWord)
+{
+	Blocklist	blocklist;
+	bool		screened = true;
+	int		rejected = 0;
+	int		i;
+
+
+	blocklist.addPattern("a");
+	blocklist.compile();
+	aRandomWord.setBlocklist(&blocklist);
+	for (i = 0; i < 1000; ++i)
+	{
+		if (aRandomWord.generate() != 0)
+		{
+			screened &= !blocklist.blocks(aRandomWord.word());
+		}
+		rejected += aRandomWord.rejectedWords();
+	}
+	aRandomWord.setBlocklist(nullptr);
+
+	selfCheck(screened, "generate() never returns a blocked word");
+	selfCheck(rejected > 0, "blocked words are counted by rejectedWords()");
+}
+
+
+
+// Blocklist matching, loading, and screening
+void testBlocklist()
+{
+	string	fileName = selfTestPath("blocklist-corpus.txt");
+
+
+	testMatching();
+	testLoad();
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the blocklist corpus"))
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		testScreening(aRandomWord);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "cstringBenchmark.h"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+// A version being timed, with the cstrings it works on
+typedef void (*CstringVersion)(char cString[], const char other[], const int& length, long long& matches);
+
+// The compare the SSE2 version replaced: both strings are copied to the heap, lowercased, and compared
+static int baselineCompareCstringToLowercase(const char cString1[], const char cString2[])
+{
+	int	stringLength1;
+	int	stringLength2;
+	char*	cString1Lowercase;
+	char*	cString2Lowercase;
+	bool	matchFlag;
+	int	i;
+
+	stringLength1 = strlen(cString1);
+	stringLength2 = strlen(cString2);
+	matchFlag = false;
+
+	if (stringLength1 == stringLength2)
+	{
+		cString1Lowercase = new char[stringLength1 + 1];
+		cString2Lowercase = new char[stringLength2 + 1];
+
+		stringCopy(cString1Lowercase, (stringLength1 + 1), cString1);
+		stringCopy(cString2Lowercase, (stringLength2 + 1), cString2);
+
+		for (i = 0; i < stringLength1; i++)
+		{
+			cString1Lowercase[i] = tolower(cString1Lowercase[i]);
+			cString2Lowercase[i] = tolower(cString2Lowercase[i]);
+		}
+
+		matchFlag = (!strcmp(cString1Lowercase, cString2Lowercase));
+
+		delete[] cString1Lowercase;
+		delete[] cString2Lowercase;
+	}
+	return matchFlag;
+}
+
+// The lowercase the SSE2 version replaced: tolower() one char at a time
+static void baselineCStringToLowercase(char cString[], const int stringLength)
+{
+	int	i;
+
+	for (i = 0; i < stringLength; i++)
+	{
+		cString[i] = tolower(cString[i]);
+	}
+}
+
+// The print the single write replaced: cout one char at a time
+static void baselinePrintCstring(const char cString[])
+{
+	int	i;
+	int	length;
+
+	length = strlen(cString);
+
+	for (i = 0; i < length; i++)
+	{
+		cout << cString[i];
+	}
+}
+
+// The versions timed, each counting the matches so the compares can't be optimized away
+static void compareBaseline(char cString[], const char other[], const int&, long long& matches)
+{
+	matches += baselineCompareCstringToLowercase(cString, other);
+}
+
+static void compareScalar(char cString[], const char other[], const int&, long long& matches)
+{
+	matches += compareCstringToLowercaseScalar(cString, other);
+}
+
+static void compareVector(char cString[], const char other[], const int&, long long& matches)
+{
+	matches += compareCstringToLowercase(cString, other);
+}
+
+static void lowercaseBaseline(char cString[], const char[], const int& length, long long& matches)
+{
+	baselineCStringToLowercase(cString, length);
+	matches += cString[0];
+}
+
+static void lowercaseScalar(char cString[], const char[], const int& length, long long& matches)
+{
+	cStringToLowercaseScalar(cString, length);
+	matches += cString[0];
+}
+
+static void lowercaseVector(char cString[], const char[], const int& length, long long& matches)
+{
+	cStringToLowercase(cString, length);
+	matches += cString[0];
+}
+
+static void printBaseline(char cString[], const char[], const int&, long long&)
+{
+	baselinePrintCstring(cString);
+}
+
+static void printWhole(char cString[], const char[], const int&, long long&)
+{
+	printCstring(cString);
+}
+
+// Runs version rounds times on a fresh mixed-case copy of source, with other the same string in lowercase
+// Returns the nanoseconds per call
+static double timeVersion(CstringVersion version, const string& source, const string& other, const int& rounds, long long& matches)
+{
+	vector<char>	cString(source.c_str(), source.c_str() + source.size() + 1);
+	int		i;
+
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (i = 0; i < rounds; ++i)
+	{
+		version(cString.data(), other.c_str(), source.size(), matches);
+	}
+	chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+	return chrono::duration<double, nano>(stop - start).count() / rounds;
+}
+
+
+
+// Runs each version rounds times on a mixed-case string of every length in CSTRING_BENCHMARK_LENGTHS,
+// displaying the nanoseconds per call
+void runCstringBenchmark(const int& rounds)
+{
+	const CstringVersion	versions[] = { compareBaseline, compareScalar, compareVector,
+						lowercaseBaseline, lowercaseScalar, lowercaseVector,
+						printBaseline, printWhole, printWhole };
+	const char*		names[] = { "compare", "lowercase", "print" };
+	double			nanoseconds[sizeof(versions) / sizeof(versions[0])];
+	stringstream		discarded;		// Where the printed strings go while timed
+	streambuf*		savedOutput;
+	long long		matches = 0;
+	string			source;
+	string			other;
+	int			length;
+	int			i;
+	int			j;
+
+
+	headerBox("Cstring Benchmark");
+	cout << "Rounds per version: " << rounds << " (ns per call: baseline / scalar / SSE2 where the target has it, print has one new version)" << endl;
+
+	for (i = 0; i < (int)(sizeof(CSTRING_BENCHMARK_LENGTHS) / sizeof(CSTRING_BENCHMARK_LENGTHS[0])); ++i)
+	{
+		length = CSTRING_BENCHMARK_LENGTHS[i];
+		source.clear();
+		for (j = 0; j < length; ++j)
+		{
+			source += (char)(((j % 3) == 0 ? 'A' : 'a') + (j % 26));
+		}
+		other = source;
+		baselineCStringToLowercase(&other[0], length);
+
+		savedOutput = cout.rdbuf(discarded.rdbuf());
+		for (j = 0; j < (int)(sizeof(versions) / sizeof(versions[0])); ++j)
+		{
+			nanoseconds[j] = timeVersion(versions[j], source, other, rounds, matches);
+			discarded.str("");
+		}
+		cout.rdbuf(savedOutput);
+
+		cout << endl << "Length " << length << ":" << endl;
+		cout << fixed << setprecision(1);
+		for (j = 0; j < 3; ++j)
+		{
+			cout << "  " << setw(10) << left << names[j] << right
+				<< setw(9) << nanoseconds[j * 3] << " / " << setw(7) << nanoseconds[j * 3 + 1] << " / " << setw(7) << nanoseconds[j * 3 + 2]
+				<< "  (" << setprecision(1) << nanoseconds[j * 3] / nanoseconds[j * 3 + 2] << "x)" << endl;
+		}
+		cout.unsetf(ios::fixed);
+		cout << setprecision(6);
+	}
+
+	// Using the count keeps the compares from being optimized away
+	cout << endl << "Checksum: " << matches << endl;
+}
\ No newline at end of file
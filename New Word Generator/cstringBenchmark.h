@@ -0,0 +1,17 @@
+#pragma once
+#include "utilities.h"
+
+
+// CSTRING BENCHMARK SETTINGS
+const int CSTRING_BENCHMARK_LENGTHS[] = { 8, 16, 40, 100, 250 };	// String lengths timed, each a row of the report
+
+
+// Cstring Benchmark Utilities
+//
+// Times compareCstringToLowercase(), cStringToLowercase() and printCstring() against the versions they
+// replaced (a heap copy of both strings, tolower() char by char, and cout char by char) and against the
+// scalar loops targets without SSE2 run
+//
+// Runs each version rounds times on a mixed-case string of every length in CSTRING_BENCHMARK_LENGTHS,
+// displaying the nanoseconds per call
+void runCstringBenchmark(const int& rounds);
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+
+// LETTER CLASS SETTINGS
+// Every char decision made while generating or scoring a word is one lookup in the tables below
+const int LETTER_COUNT = 26;		// 'a'-'z' without regard to case
+const int LETTER_NONE = LETTER_COUNT;	// Index of every char that isn't a letter
+const int VOWEL_COUNT = 5;		// a, e, i, o, u
+const int CONSONANT_COUNT = LETTER_COUNT - VOWEL_COUNT;
+
+const unsigned char LETTER_VOWEL = 1;		// Class bit of a, e, i, o, u in either case
+const unsigned char LETTER_CONSONANT = 2;	// Class bit of every other letter in either case
+
+// Vowels, then consonants, so either set is a slice of one array
+constexpr char LETTER_SETS[LETTER_COUNT + 1] = "aeioubcdfghjklmnpqrstvwxyz";
+
+
+// Lookup tables for every char value, built at compile time by buildLetterTables()
+struct LetterTables
+{
+	unsigned char	index[256];			// 0-25 for 'a'-'z' and 'A'-'Z', LETTER_NONE for everything else
+	unsigned char	charClass[256];			// LETTER_VOWEL, LETTER_CONSONANT, or 0 for everything else
+	unsigned char	indexClass[LETTER_COUNT + 1];	// charClass of each index (0 for LETTER_NONE)
+	unsigned char	oppositeStart[2];		// Where the set of the other class starts in LETTER_SETS, by "is a vowel"
+	unsigned char	oppositeCount[2];		// How many letters that set holds, by "is a vowel"
+};
+
+// Returns the filled in LetterTables
+constexpr LetterTables buildLetterTables()
+{
+	LetterTables	tables = {};
+	int		i = 0;
+
+
+	for (i = 0; i < 256; ++i)
+	{
+		tables.index[i] = LETTER_NONE;
+	}
+	for (i = 0; i < LETTER_COUNT; ++i)
+	{
+		tables.index['a' + i] = (unsigned char)i;
+		tables.index['A' + i] = (unsigned char)i;
+	}
+
+	// LETTER_SETS holds the vowels first
+	for (i = 0; i < LETTER_COUNT; ++i)
+	{
+		tables.indexClass[LETTER_SETS[i] - 'a'] = (i < VOWEL_COUNT) ? LETTER_VOWEL : LETTER_CONSONANT;
+	}
+	for (i = 0; i < 256; ++i)
+	{
+		tables.charClass[i] = tables.indexClass[tables.index[i]];
+	}
+
+	// After a consonant (or anything else) the other class is the vowels, after a vowel it is the consonants
+	tables.oppositeStart[0] = 0;
+	tables.oppositeCount[0] = VOWEL_COUNT;
+	tables.oppositeStart[1] = VOWEL_COUNT;
+	tables.oppositeCount[1] = CONSONANT_COUNT;
+
+	return tables;
+}
+
+constexpr LetterTables LETTER_TABLES = buildLetterTables();
+
+
+
+// LETTER CLASSES
+//
+// Returns 0-25 for a letter in either case, or LETTER_NONE for anything else
+inline int letterIndex(const char& aChar)
+{
+	return LETTER_TABLES.index[(unsigned char)aChar];
+}
+//
+// Check if aChar is a letter in either case
+inline bool isLetter(const char& aChar)
+{
+	return (LETTER_TABLES.charClass[(unsigned char)aChar] != 0);
+}
+//
+// Check if aChar is a, e, i, o or u in either case
+inline bool isVowel(const char& aChar)
+{
+	return (LETTER_TABLES.charClass[(unsigned char)aChar] == LETTER_VOWEL);
+}
+//
+// Check if a letterIndex() is a consonant (LETTER_NONE is not)
+inline bool isConsonantIndex(const int& index)
+{
+	return (LETTER_TABLES.indexClass[index] == LETTER_CONSONANT);
+}
+
+
+
+// LETTER SAMPLING
+// Each sampler takes 32 uniform random bits, so the scalar and batched generators can share them
+//
+// Returns a uniform number from 0 to count - 1 (multiply and shift, no division or retries)
+inline int sampleBelow(const unsigned int& randomBits, const int& count)
+{
+	return (int)(((unsigned long long)randomBits * (unsigned int)count) >> 32);
+}
+//
+// Returns a random lowercase letter
+inline char sampleLetter(const unsigned int& randomBits)
+{
+	return (char)('a' + sampleBelow(randomBits, LETTER_COUNT));
+}
+//
+// Returns a random lowercase vowel
+inline char sampleVowel(const unsigned int& randomBits)
+{
+	return LETTER_SETS[sampleBelow(randomBits, VOWEL_COUNT)];
+}
+//
+// Returns a random lowercase consonant
+inline char sampleConsonant(const unsigned int& randomBits)
+{
+	return LETTER_SETS[VOWEL_COUNT + sampleBelow(randomBits, CONSONANT_COUNT)];
+}
+//
+// Returns a random consonant if aChar is a vowel, or a random vowel otherwise
+inline char sampleOpposite(const char& aChar, const unsigned int& randomBits)
+{
+	const int	vowel = isVowel(aChar);
+
+	return LETTER_SETS[LETTER_TABLES.oppositeStart[vowel] + sampleBelow(randomBits, LETTER_TABLES.oppositeCount[vowel])];
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "selfTest.h"
+#include "randomWord.h"
+#include <cctype>
+#include <set>
+
+using namespace std;
+
+// Checks every char of the lookup tables against the <cctype> answer
+static void testTables()
+{
+	bool	matching = true;
+	char	aChar;
+	int	i;
+
+
+	for (i = 0; i < 256; ++i)
+	{
+		aChar = (char)i;
+		matching &= (isLetter(aChar) == ((i < 128) && (isalpha(i) != 0)));
+		matching &= (letterIndex(aChar) == (isLetter(aChar) ? (tolower(i) - 'a') : LETTER_NONE));
+		matching &= (isVowel(aChar) == ((i != 0) && (strchr("aeiouAEIOU", i) != nullptr)));
+		matching &= (isConsonantIndex(letterIndex(aChar)) == (isLetter(aChar) && !isVowel(aChar)));
+	}
+
+	selfCheck(matching, "the letter tables agree with <cctype> for all 256 chars");
+}
+
+// Checks that each sampler covers its whole set, and nothing outside it, evenly
+static void testSamplers()
+{
+	int		buckets[LETTER_COUNT] = { 0 };
+	set<char>	vowels;
+	set<char>	consonants;
+	bool		even = true;
+	bool		classes = true;
+	unsigned int	randomBits;
+	int		i;
+
+
+	for (i = 0; i < LETTER_COUNT * 1000; ++i)
+	{
+		randomBits = (unsigned int)((((unsigned long long)i << 32) + (LETTER_COUNT * 1000) - 1) / (LETTER_COUNT * 1000));
+		++buckets[sampleBelow(randomBits, LETTER_COUNT)];
+		vowels.insert(sampleVowel(randomBits));
+		consonants.insert(sampleConsonant(randomBits));
+		classes &= (sampleLetter(randomBits) >= 'a') && (sampleLetter(randomBits) <= 'z');
+		classes &= (!isVowel(sampleOpposite('e', randomBits))) && (isVowel(sampleOpposite('T', randomBits))) && (isVowel(sampleOpposite('-', randomBits)));
+	}
+	for (i = 0; i < LETTER_COUNT; ++i)
+	{
+		even &= (buckets[i] == 1000);
+	}
+
+	selfCheck(even, "sampleBelow() splits evenly spaced bits evenly");
+	selfCheck((vowels.size() == VOWEL_COUNT) && (consonants.size() == CONSONANT_COUNT) && (isVowel(*vowels.begin())) && (!isVowel(*consonants.begin())),
+		"sampleVowel() and sampleConsonant() draw every letter of their class");
+	selfCheck(classes, "sampleOpposite() draws the other class, and a vowel after anything that isn't one");
+}
+
+// Checks that two-letter words hold one vowel and one consonant, as generateTwoLetterWord() promises
+static void testTwoLetterWords(RandomWord& aRandomWord)
+{
+	LengthDistribution	lengths;
+	bool			mixed = true;
+	int			i;
+
+
+	lengths.setUniform(2, 2);
+	aRandomWord.setLengthDistribution(&lengths);
+	for (i = 0; i < 500; ++i)
+	{
+		aRandomWord.generate();
+		mixed &= (strlen(aRandomWord.word()) == 2) && (isVowel(aRandomWord.word()[0]) != isVowel(aRandomWord.word()[1]));
+	}
+	aRandomWord.setLengthDistribution(nullptr);
+
+	selfCheck(mixed, "every two-letter word holds one vowel and one consonant");
+}
+
+
+
+// Letter tables and the samplers built on them
+void testLetterSampler()
+{
+	string	fileName = selfTestPath("sampler.txt");
+
+
+	testTables();
+	testSamplers();
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the sampler corpus"))
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		testTwoLetterWords(aRandomWord);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
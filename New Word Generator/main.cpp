@@ -1,10 +1,347 @@
 #include "randomWord.h"
+#include "wordRun.h"
+#include "verify.h"
+#include "profileRegistry.h"
+#include "selfTest.h"
+#include "cstringBenchmark.h"
+#include <chrono>
+#include <vector>
+#include <cstdio>
 
 using namespace std;
 
-int main()
+// Generates wordCount words with the given work budget and reports the latency percentiles
+void runBenchmark(RandomWord& aRandomWord, const int& wordCount, const int& workBudget);
+
+int main(int argc, char* argv[])
 {
-	RandomWord	aRandomWord;
+	string		corpusFile = "words.txt";	// Donor word file chosen with --corpus
+	long		memoryCap = 0;			// Most bytes the corpus may use with --memory-cap (0 for no limit)
+	bool		memoryReport = false;		// Display the memory breakdown with --memory-report
+	string		modelFile;			// File to write the loaded corpus to with --save-model
+	string		blocklistFile;			// Banned substrings to screen out with --blocklist
+	Blocklist	blocklist;
+	PronounceScorer	scorer;
+	double		keepFraction = 0;		// Share of each batch kept with --pronounceable (0 keeps every word)
+	string		lengthSpec;			// Word length distribution chosen with --lengths
+	LengthDistribution	lengths;
+	int		smallest;			// Bounds of a --lengths range
+	int		largest;
+	string		traceFile;			// Chrome trace of the startup phases written with --trace
+	long long	verifyWords = 0;		// Words each generator makes with --verify (0 to skip)
+	double		throughputFloor = 0;		// Fewest words per second a generator may make with --verify-floor
+	string		verifyBaseline;			// Speeds --verify compares with, given with --verify-baseline
+	string		verifyRecord;			// File --verify writes its speeds to with --verify-record
+	bool		unique = false;			// Make every word of --count different with --unique
+	long		uniqueCap = 0;			// Most bytes the unique set may keep in memory with --unique-cap (0 for the default)
+	string		uniqueSpill;			// Directory --unique spills runs to with --unique-spill (empty for the temporary directory)
+	unique_ptr<UniqueWordSet>	uniqueWords;	// Words --count has made so far
+	string		metricsFile;			// Prometheus text file rewritten while --count runs with --metrics
+	unique_ptr<RunMetrics>		metrics;	// The run's live counters
+	MemoryStats	memory;				// Corpus bytes for --metrics
+	long		profileCap = 0;			// Most bytes the loaded profiles may use with --profile-cap (0 for no limit)
+	vector<string>	profileSpecs;			// name=file pairs given with --profile
+	string		useProfile;			// Profile chosen with --use instead of --corpus
+	shared_ptr<RandomWord>		profileCorpus;	// The corpus of useProfile, owned by the registry
+	unique_ptr<RandomWord>		generator;	// The generator everything below uses
+	int		acquired;			// What the registry returned for useProfile
+	int		phase;				// Startup phase being traced
+	int		benchmarkWords = 0;	// Number of words to time with --benchmark (0 to skip)
+	int		workBudget = 0;		// Most donor words examined per word with --budget (0 for no limit)
+	bool		selfTest = false;	// Run the checks of every module with --self-test instead of generating
+	int		cstringRounds = 0;	// Calls of each cstring utility to time with --benchmark-cstring (0 to skip)
+	RunSettings	run;				// Words to print with --count, --threads and --stats
+	int		i;
+
+
+	// Read the command line options
+	for (i = 1; i < argc; ++i)
+	{
+		if ((!strcmp(argv[i], "--benchmark")) && (i + 1 < argc))
+		{
+			cStringToInt(argv[++i], benchmarkWords);
+		}
+		else if ((!strcmp(argv[i], "--benchmark-cstring")) && (i + 1 < argc) && (cStringToInt(argv[i + 1], cstringRounds)) && (cstringRounds > 0))
+		{
+			++i;
+		}
+		else if (!strcmp(argv[i], "--self-test"))
+		{
+			selfTest = true;
+		}
+		else if ((!strcmp(argv[i], "--budget")) && (i + 1 < argc))
+		{
+			cStringToInt(argv[++i], workBudget);
+		}
+		else if ((!strcmp(argv[i], "--corpus")) && (i + 1 < argc))
+		{
+			corpusFile = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--memory-cap")) && (i + 1 < argc) && (cStringToLong(argv[i + 1], memoryCap)) && (memoryCap >= 0))
+		{
+			++i;
+		}
+		else if (!strcmp(argv[i], "--memory-report"))
+		{
+			memoryReport = true;
+		}
+		else if ((!strcmp(argv[i], "--save-model")) && (i + 1 < argc))
+		{
+			modelFile = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--blocklist")) && (i + 1 < argc))
+		{
+			blocklistFile = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--count")) && (i + 1 < argc))
+		{
+			run.wordCount = atoll(argv[++i]);
+		}
+		else if ((!strcmp(argv[i], "--threads")) && (i + 1 < argc))
+		{
+			cStringToInt(argv[++i], run.threadCount);
+		}
+		else if (!strcmp(argv[i], "--stats"))
+		{
+			run.collectStats = true;
+		}
+		else if (!strcmp(argv[i], "--batched"))
+		{
+			run.batched = true;
+		}
+		else if (!strcmp(argv[i], "--unique"))
+		{
+			unique = true;
+		}
+		else if ((!strcmp(argv[i], "--unique-cap")) && (i + 1 < argc) && (cStringToLong(argv[i + 1], uniqueCap)) && (uniqueCap >= 0))
+		{
+			++i;
+		}
+		else if ((!strcmp(argv[i], "--unique-spill")) && (i + 1 < argc))
+		{
+			uniqueSpill = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--metrics")) && (i + 1 < argc))
+		{
+			metricsFile = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--pronounceable")) && (i + 1 < argc))
+		{
+			keepFraction = atof(argv[++i]);
+		}
+		else if ((!strcmp(argv[i], "--lengths")) && (i + 1 < argc))
+		{
+			lengthSpec = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--trace")) && (i + 1 < argc))
+		{
+			traceFile = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--verify")) && (i + 1 < argc))
+		{
+			verifyWords = atoll(argv[++i]);
+		}
+		else if ((!strcmp(argv[i], "--verify-floor")) && (i + 1 < argc))
+		{
+			throughputFloor = atof(argv[++i]);
+		}
+		else if ((!strcmp(argv[i], "--verify-baseline")) && (i + 1 < argc))
+		{
+			verifyBaseline = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--verify-record")) && (i + 1 < argc))
+		{
+			verifyRecord = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--profile")) && (i + 1 < argc))
+		{
+			profileSpecs.push_back(argv[++i]);
+		}
+		else if ((!strcmp(argv[i], "--use")) && (i + 1 < argc))
+		{
+			useProfile = argv[++i];
+		}
+		else if ((!strcmp(argv[i], "--profile-cap")) && (i + 1 < argc) && (cStringToLong(argv[i + 1], profileCap)) && (profileCap >= 0))
+		{
+			++i;
+		}
+		// Anything else, including a cap that isn't a whole number of bytes, shows how to call the program
+		else
+		{
+			cerr << "Usage: " << argv[0] << " [--corpus file] [--memory-cap bytes] [--memory-report] [--save-model file]" << endl;
+			cerr << "       [--blocklist file] [--count words] [--threads count] [--stats] [--batched]" << endl;
+			cerr << "       [--pronounceable fraction] [--lengths smallest-largest|corpus|file] [--trace file] [--benchmark words]" << endl;
+			cerr << "       [--budget donorPicks] [--verify words] [--verify-floor wordsPerSecond] [--verify-baseline file]" << endl;
+			cerr << "       [--verify-record file] [--profile name=file]... [--use name] [--profile-cap bytes]" << endl;
+			cerr << "       [--unique] [--unique-cap bytes] [--unique-spill directory] [--metrics file] [--self-test]" << endl;
+			cerr << "       [--benchmark-cstring rounds]" << endl;
+			return 1;
+		}
+	}
+
+	// The self test makes its own corpora, so it needs nothing loaded
+	if (selfTest)
+	{
+		return (runSelfTests() != 0) ? 0 : 1;
+	}
+
+	// As does timing the cstring utilities
+	if (cstringRounds > 0)
+	{
+		runCstringBenchmark(cstringRounds);
+		return 0;
+	}
+
+	// Everything from here until the trace is written counts as startup
+	if (!traceFile.empty())
+	{
+		enableTracing();
+	}
+
+	phase = beginTracePhase("load blocklist");
+	if ((!blocklistFile.empty()) && (blocklist.load(blocklistFile) == -1))
+	{
+		return 1;
+	}
+	endTracePhase(phase, blocklist.memoryBytes(), blocklist.patternCount());
+
+	ProfileRegistry	profiles(profileCap);
+
+	for (i = 0; i < (int)profileSpecs.size(); ++i)
+	{
+		if (profiles.addProfile(profileSpecs[i]) == 0)
+		{
+			cerr << "Error! --profile " << profileSpecs[i] << " is not name=file" << endl;
+			return 1;
+		}
+	}
+
+	// A profile is loaded by the registry and borrowed, anything else is loaded here
+	if (!useProfile.empty())
+	{
+		// A file that couldn't be loaded has already been displayed
+		acquired = profiles.acquire(useProfile, profileCorpus);
+		if (acquired == 0)
+		{
+			cerr << "Error! --use " << useProfile << " is not a --profile" << endl;
+		}
+		if (acquired != 1)
+		{
+			return 1;
+		}
+		generator.reset(new RandomWord(profileCorpus.get()));
+	}
+	else
+	{
+		generator.reset(new RandomWord(corpusFile, memoryCap));
+	}
+
+	RandomWord&	aRandomWord = *generator;
+
+	// The reason the corpus couldn't be loaded has already been displayed
+	if (aRandomWord.listSize() == 0)
+	{
+		return 1;
+	}
+	aRandomWord.setBlocklist(&blocklist);
+
+	// A range of lengths, the lengths of the donor words, or a table of weights
+	if (!lengthSpec.empty())
+	{
+		if (sscanf(lengthSpec.c_str(), "%d-%d", &smallest, &largest) == 2)
+		{
+			if (lengths.setUniform(smallest, largest) == 0)
+			{
+				cerr << "Error! --lengths must be within " << SMALLEST_WORD << "-" << LONGEST_LENGTH << endl;
+				return 1;
+			}
+		}
+		else if (lengthSpec == "corpus")
+		{
+			lengths.setEmpirical(aRandomWord);
+		}
+		else
+		{
+			lengths.load(lengthSpec);
+		}
+
+		if (lengths.empty())
+		{
+			cerr << "Error! --lengths " << lengthSpec << " gives no usable length" << endl;
+			return 1;
+		}
+		aRandomWord.setLengthDistribution(&lengths);
+		run.lengths = &lengths;
+	}
+
+	if (memoryReport)
+	{
+		aRandomWord.displayMemoryReport();
+		if (profiles.profileCount() > 0)
+		{
+			profiles.displayReport();
+		}
+	}
+
+	if ((!modelFile.empty()) && (aRandomWord.saveModel(modelFile) == 0))
+	{
+		return 1;
+	}
+
+	if ((run.wordCount > 0) && (keepFraction > 0))
+	{
+		phase = beginTracePhase("train scorer");
+		scorer.train(aRandomWord);
+		endTracePhase(phase, sizeof(scorer), aRandomWord.listSize());
+		run.scorer = &scorer;
+		run.keepFraction = min(keepFraction, 1.0);
+	}
+
+	if ((!traceFile.empty()) && (writeTrace(traceFile) == 0))
+	{
+		return 1;
+	}
+
+	if (run.wordCount > 0)
+	{
+		run.workBudget = workBudget;
+		if (unique)
+		{
+			uniqueWords.reset(new UniqueWordSet(uniqueCap, uniqueSpill));
+			run.unique = uniqueWords.get();
+		}
+		if (!metricsFile.empty())
+		{
+			aRandomWord.memoryStats(memory);
+			metrics.reset(new RunMetrics(metricsFile));
+			metrics->setCorpusBytes(memory.totalBytes);
+			run.metrics = metrics.get();
+		}
+		return (runWords(aRandomWord, &blocklist, run) != 0) ? 0 : 1;
+	}
+
+	if (verifyWords > 0)
+	{
+		// Mapping a model only checked its header, so check every word of it before trusting the results
+		if (!aRandomWord.modelIntact())
+		{
+			cerr << "Error! The model file of the corpus is damaged" << endl;
+			return 1;
+		}
+		return (runVerify(aRandomWord, run.lengths, verifyWords, throughputFloor, verifyBaseline, verifyRecord) != 0) ? 0 : 1;
+	}
+
+	if (benchmarkWords > 0)
+	{
+		runBenchmark(aRandomWord, benchmarkWords, workBudget);
+		return 0;
+	}
+
+	// The constructor's word was never screened, so always make a fresh one when screening
+	if ((workBudget > 0) || (blocklist.patternCount() > 0) || (!lengths.empty()))
+	{
+		aRandomWord.generate(workBudget);
+	}
 
 	cout << endl;
 	cout << "Randomly generate a word " << endl;
@@ -13,4 +350,62 @@ int main()
 	cout << endl;
 
 	return 0;
+}
+
+// Generates wordCount words with the given work budget and reports the latency percentiles
+void runBenchmark(RandomWord& aRandomWord, const int& wordCount, const int& workBudget)
+{
+	vector<double>	latencies;		// Time taken by each word in microseconds
+	int		budgetWords = 0;	// Number of words that ran out of budget
+	int		failedWords = 0;	// Number of words that could not be generated
+	long		rejectedWords = 0;	// Number of blocked words that were replaced
+	int		mostPicks = 0;		// Largest number of donor words examined by a single word
+	double		totalTime = 0;		// Sum of all latencies in microseconds
+	long long	totalLetters = 0;	// Sum of the lengths of every word generated
+	int		i;
+
+
+	latencies.reserve(wordCount);
+
+	for (i = 0; i < wordCount; ++i)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		int status = aRandomWord.generate(workBudget);
+		chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+		latencies.push_back(chrono::duration<double, micro>(stop - start).count());
+		totalTime += latencies.back();
+
+		if (status == 2)
+		{
+			++budgetWords;
+		}
+		else if (status == 0)
+		{
+			++failedWords;
+		}
+		rejectedWords += aRandomWord.rejectedWords();
+		if (aRandomWord.word() != nullptr)
+		{
+			totalLetters += strlen(aRandomWord.word());
+		}
+		mostPicks = max(mostPicks, aRandomWord.donorPicks());
+	}
+
+	sort(latencies.begin(), latencies.end());
+
+	headerBox("Benchmark");
+	cout << "Words generated:    " << wordCount << endl;
+	cout << "Work budget:        " << workBudget << (workBudget == 0 ? " (no limit)" : "") << endl;
+	cout << "Words over budget:  " << budgetWords << endl;
+	cout << "Words failed:       " << failedWords << endl;
+	cout << "Blocked and redone: " << rejectedWords << endl;
+	cout << "Most donor picks:   " << mostPicks << endl;
+	cout << "Words per second:   " << (totalTime > 0 ? (wordCount / (totalTime / 1e6)) : 0) << endl;
+	cout << "Letters per word:   " << (double)totalLetters / wordCount << endl;
+	cout << "ns per letter:      " << (totalLetters > 0 ? (totalTime * 1000 / totalLetters) : 0) << endl;
+	cout << "p50 latency (us):   " << latencies[(size_t)(0.50 * (wordCount - 1))] << endl;
+	cout << "p99 latency (us):   " << latencies[(size_t)(0.99 * (wordCount - 1))] << endl;
+	cout << "p99.9 latency (us): " << latencies[(size_t)(0.999 * (wordCount - 1))] << endl;
+	cout << "Max latency (us):   " << latencies.back() << endl;
 }
\ No newline at end of file
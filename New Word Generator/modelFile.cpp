@@ -0,0 +1,144 @@
+#include "modelFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Check if fileName starts with MODEL_MAGIC
+bool isModelFile(const string& fileName)
+{
+	ifstream	in;
+	char		magic[sizeof(MODEL_MAGIC)];
+
+
+	in.open(fileName, ios::binary);
+	if (!in)
+	{
+		return false;
+	}
+	in.read(magic, sizeof(magic));
+
+	return ((in.gcount() == sizeof(magic)) && (!memcmp(magic, MODEL_MAGIC, sizeof(magic))));
+}
+
+// Maps fileName read-only into memory, shared with every other process mapping it
+// Returns the start of the mapping and sets fileBytes to its size, or returns nullptr on failure
+const char* mapModelFile(const string& fileName, long long& fileBytes)
+{
+	const char*	mapping = nullptr;
+
+
+	fileBytes = 0;
+
+#ifdef _WIN32
+	HANDLE		file;
+	HANDLE		section;
+	LARGE_INTEGER	size;
+
+	file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return nullptr;
+	}
+	if (GetFileSizeEx(file, &size))
+	{
+		section = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (section != NULL)
+		{
+			mapping = (const char*)MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+			fileBytes = (mapping != nullptr) ? size.QuadPart : 0;
+			// The view keeps the section alive after its handle is closed
+			CloseHandle(section);
+		}
+	}
+	CloseHandle(file);
+#else
+	int		file;
+	struct stat	status;
+	void*		view;
+
+	file = open(fileName.c_str(), O_RDONLY);
+	if (file == -1)
+	{
+		return nullptr;
+	}
+	if ((fstat(file, &status) == 0) && (status.st_size > 0))
+	{
+		view = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, file, 0);
+		if (view != MAP_FAILED)
+		{
+			mapping = (const char*)view;
+			fileBytes = status.st_size;
+		}
+	}
+	// The mapping keeps the file alive after it is closed
+	close(file);
+#endif
+
+	return mapping;
+}
+
+// Check if a section of sectionBytes starting at sectionAt lies after the header and inside a file of fileBytes,
+// on a MODEL_ALIGNMENT boundary
+// Returns true if it does
+static bool modelSectionFits(const long long& sectionAt, const long long& sectionBytes, const long long& fileBytes)
+{
+	return ((sectionAt >= (long long)sizeof(ModelHeader)) && ((sectionAt % MODEL_ALIGNMENT) == 0) && (sectionAt <= fileBytes - sectionBytes));
+}
+
+// Check if the counts in header are ones a saved corpus can have, and every section it records lies inside
+// a file of fileBytes, on a MODEL_ALIGNMENT boundary (indexBytes is the size of the successor index section)
+// Returns true if they are
+bool modelHeaderValid(const ModelHeader& header, const long long& fileBytes, const long long& indexBytes)
+{
+	// The membership table is a power of 2 and always keeps an empty slot to end its probes
+	if ((header.listSize < 0) || (header.arenaUsed < 0) || (header.sampleStride < 1) || (header.slotCount <= 0) ||
+		((header.slotCount & (header.slotCount - 1)) != 0) || (header.slotsUsed < 0) || (header.slotsUsed >= header.slotCount))
+	{
+		return false;
+	}
+
+	return ((header.fileBytes == fileBytes) &&
+		(modelSectionFits(header.offsetsAt, (long long)header.listSize * sizeof(int), fileBytes)) &&
+		(modelSectionFits(header.arenaAt, header.arenaUsed, fileBytes)) &&
+		(modelSectionFits(header.slotsAt, (long long)header.slotCount * sizeof(int), fileBytes)) &&
+		(modelSectionFits(header.indexAt, indexBytes, fileBytes)));
+}
+
+// Adds count bytes to checksum (64-bit FNV-1a), which starts at MODEL_CHECKSUM_START
+void addModelChecksum(unsigned long long& checksum, const char bytes[], const long long& count)
+{
+	long long	i;
+
+
+	for (i = 0; i < count; ++i)
+	{
+		checksum ^= (unsigned char)bytes[i];
+		checksum *= 1099511628211ULL;
+	}
+}
+
+// Unmaps a mapping returned by mapModelFile()
+void unmapModelFile(const char* mapping, const long long& fileBytes)
+{
+	if (mapping != nullptr)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mapping);
+#else
+		munmap((void*)mapping, fileBytes);
+#endif
+	}
+}
+
+// Returns offset rounded up to the next MODEL_ALIGNMENT boundary
+long long alignModelOffset(const long long& offset)
+{
+	return (offset + MODEL_ALIGNMENT - 1) / MODEL_ALIGNMENT * MODEL_ALIGNMENT;
+}
\ No newline at end of file
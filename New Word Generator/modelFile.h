@@ -0,0 +1,58 @@
+#pragma once
+#include "utilities.h"
+
+
+// MODEL FILE SETTINGS
+// A model file holds a loaded corpus in the same layout RandomWord keeps in memory, so it
+// can be mapped read-only and shared by every process on the host instead of re-parsing words.txt.
+// Mapping only checks the header, that every section lies inside the file, and the successor counts,
+// which touches a few pages whatever the corpus size. Each donor word and membership slot is trusted
+// until RandomWord::modelIntact() checks them and the checksum, which reads the whole file (about
+// 1.5 ms per MB) and is run by --verify.
+const char MODEL_MAGIC[8] = { 'R', 'W', 'M', 'O', 'D', 'E', 'L', '1' };	// First 8 bytes of every model file
+const int MODEL_VERSION = 3;		// Bumped whenever the layout below changes
+const int MODEL_ALIGNMENT = 64;		// Every section starts on a cache line
+const unsigned long long MODEL_CHECKSUM_START = 14695981039346656037ULL;	// Checksum of no bytes (the FNV-1a offset basis)
+
+
+// The start of a model file, followed by each section at the recorded byte offset
+struct ModelHeader
+{
+	char		magic[8];		// MODEL_MAGIC
+	int		version;		// MODEL_VERSION
+	int		listSize;		// Number of donor words
+	int		arenaUsed;		// Chars of the word arena section
+	int		slotCount;		// Entries of the membership table section
+	int		slotsUsed;		// Entries of the membership table that are not EMPTY_SLOT
+	int		sampleStride;		// Sample stride the corpus was loaded with
+	long long	offsetsAt;		// int[listSize], where each word starts in the arena
+	long long	arenaAt;		// char[arenaUsed], every word after a length byte and before a null
+	long long	slotsAt;		// int[slotCount], the membership table
+	long long	indexAt;		// SuccessorIndex, the letter successor counts
+	long long	fileBytes;		// Size of the whole file
+	unsigned long long	checksum;	// addModelChecksum() of every byte after the header
+};
+
+
+// Model File Utilities
+//
+// Check if fileName starts with MODEL_MAGIC
+bool isModelFile(const string& fileName);
+//
+// Maps fileName read-only into memory, shared with every other process mapping it
+// Returns the start of the mapping and sets fileBytes to its size, or returns nullptr on failure
+const char* mapModelFile(const string& fileName, long long& fileBytes);
+//
+// Check if the counts in header are ones a saved corpus can have, and every section it records lies inside
+// a file of fileBytes, on a MODEL_ALIGNMENT boundary (indexBytes is the size of the successor index section)
+// Returns true if they are
+bool modelHeaderValid(const ModelHeader& header, const long long& fileBytes, const long long& indexBytes);
+//
+// Adds count bytes to checksum (64-bit FNV-1a), which starts at MODEL_CHECKSUM_START
+void addModelChecksum(unsigned long long& checksum, const char bytes[], const long long& count);
+//
+// Unmaps a mapping returned by mapModelFile()
+void unmapModelFile(const char* mapping, const long long& fileBytes);
+//
+// Returns offset rounded up to the next MODEL_ALIGNMENT boundary
+long long alignModelOffset(const long long& offset);
\ No newline at end of file
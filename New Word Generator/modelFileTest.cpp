@@ -0,0 +1,138 @@
+#include "selfTest.h"
+#include "randomWord.h"
+#include <sstream>
+
+using namespace std;
+
+// Returns the whole of fileName
+static string readWholeFile(const string& fileName)
+{
+	ifstream	in(fileName, ios::binary);
+	stringstream	contents;
+
+
+	contents << in.rdbuf();
+
+	return contents.str();
+}
+
+// Writes model to fileName with change applied to it, then maps it
+// Returns true if the changed model was refused
+static bool refusesModel(const string& model, const string& fileName, void (*change)(string& model, const ModelHeader& header))
+{
+	string		changed = model;
+	ModelHeader	header;
+	ofstream	out;
+	bool		refused;
+
+
+	memcpy(&header, model.data(), sizeof(header));
+	change(changed, header);
+
+	out.open(fileName, ios::binary | ios::trunc);
+	out.write(changed.data(), changed.size());
+	out.close();
+
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		refused = (aRandomWord.listSize() == 0) && (aRandomWord.word() == nullptr);
+	}
+	remove(fileName.c_str());
+
+	return refused;
+}
+
+// Writes model to fileName with change applied to it, and its checksum made to match again if matchChecksum, then maps it
+// Returns true if the changed model was mapped, but modelIntact() found the change
+static bool failsCheck(const string& model, const string& fileName, const bool& matchChecksum, void (*change)(string& model, const ModelHeader& header))
+{
+	string			changed = model;
+	ModelHeader		header;
+	unsigned long long	checksum = MODEL_CHECKSUM_START;
+	ofstream		out;
+	bool			caught;
+
+
+	memcpy(&header, model.data(), sizeof(header));
+	change(changed, header);
+	if (matchChecksum)
+	{
+		addModelChecksum(checksum, changed.data() + sizeof(header), changed.size() - sizeof(header));
+		memcpy(&changed[offsetof(ModelHeader, checksum)], &checksum, sizeof(checksum));
+	}
+
+	out.open(fileName, ios::binary | ios::trunc);
+	out.write(changed.data(), changed.size());
+	out.close();
+
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		caught = (aRandomWord.listSize() > 0) && (!aRandomWord.modelIntact());
+	}
+	remove(fileName.c_str());
+
+	return caught;
+}
+
+// Writes value over the int at byte position of model
+static void writeInt(string& model, const long long& position, const int& value)
+{
+	memcpy(&model[position], &value, sizeof(value));
+}
+
+
+
+// Model files: saving, mapping, and refusing damaged ones
+void testModelFile()
+{
+	string	corpusFile = selfTestPath("model.txt");
+	string	modelFile = selfTestPath("model.rwm");
+	string	damagedFile = selfTestPath("damaged.rwm");
+	string	model;
+
+
+	if (!selfCheck(writeTestCorpus(corpusFile, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the model corpus"))
+	{
+		return;
+	}
+
+	{
+		RandomWord	loaded(corpusFile, 0);
+
+		if (selfCheck(loaded.saveModel(modelFile) != 0, "save a model"))
+		{
+			RandomWord	mapped(modelFile, 0);
+			MemoryStats	stats;
+
+			mapped.memoryStats(stats);
+			selfCheck((mapped.listSize() == loaded.listSize()) && (!strcmp(mapped.donorWord(100), loaded.donorWord(100))) &&
+				(mapped.isDonorWord(loaded.donorWord(100))) && (mapped.successorIndex().matches(loaded.successorIndex())) && (stats.sharedBytes > 0),
+				"a mapped model holds the corpus it was saved from");
+			selfCheck((mapped.modelIntact()) && (loaded.modelIntact()), "a saved model, and a corpus read from words, are intact");
+		}
+	}
+	model = readWholeFile(modelFile);
+
+	selfCheck(refusesModel(model, damagedFile, [](string& model, const ModelHeader&) { model.resize(model.size() - 100); }),
+		"a truncated model is refused");
+	selfCheck(refusesModel(model, damagedFile, [](string& model, const ModelHeader& header)
+		{ writeInt(model, offsetof(ModelHeader, slotCount), header.slotCount * 4); }), "a model with a membership table past its end is refused");
+	selfCheck(refusesModel(model, damagedFile, [](string& model, const ModelHeader&)
+		{ writeInt(model, offsetof(ModelHeader, listSize), -1); }), "a model with a negative word count is refused");
+	selfCheck(refusesModel(model, damagedFile, [](string& model, const ModelHeader& header)
+		{ writeInt(model, header.indexAt, -5); }), "a model with a negative successor count is refused");
+
+	// Damage inside the sections is only found by the full check, so it is kept to what generating can't trip over
+	selfCheck(refusesModel(model, damagedFile, [](string&, const ModelHeader&) {}) == false, "an undamaged model is mapped");
+	selfCheck(failsCheck(model, damagedFile, false, [](string& model, const ModelHeader& header) { model[header.arenaAt + 1] ^= 1; }),
+		"a model with a changed letter fails its checksum");
+	selfCheck(!failsCheck(model, damagedFile, true, [](string& model, const ModelHeader& header) { model[header.arenaAt + 1] ^= 1; }),
+		"a changed letter with a checksum to match is a model like any other");
+	selfCheck(failsCheck(model, damagedFile, true, [](string& model, const ModelHeader& header) { writeInt(model, header.slotsAt, header.listSize); }),
+		"a model with a slot past the donor list fails the full check, even with a matching checksum");
+
+	remove(modelFile.c_str());
+	remove(corpusFile.c_str());
+}
\ No newline at end of file
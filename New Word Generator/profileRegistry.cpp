@@ -0,0 +1,224 @@
+#include "profileRegistry.h"
+
+using namespace std;
+
+ProfileRegistry::ProfileRegistry(const long& memoryCap) : _memoryCap(memoryCap)
+{
+	_loadedBytes = 0;
+}
+
+
+
+// Registers profile name for fileName without loading it (a name added again points at the new file)
+// Returns 0 if name or fileName is empty, 1 for success
+int ProfileRegistry::addProfile(const string& name, const string& fileName)
+{
+	lock_guard<mutex>	hold(_lock);
+	Profile*		profile;
+
+
+	if ((name.empty()) || (fileName.empty()))
+	{
+		return 0;
+	}
+
+	profile = &_profiles[name];
+	if (profile->corpus != nullptr)
+	{
+		// The old corpus stays alive for anyone still holding it
+		_loadedBytes -= profile->bytes;
+		_recent.erase(profile->recent);
+		profile->corpus.reset();
+	}
+	// A load of the old file still finishes for the callers waiting on it, but isn't kept
+	profile->loading = shared_future<shared_ptr<RandomWord>>();
+	profile->fileName = fileName;
+	++profile->fileNumber;
+	profile->bytes = 0;
+	profile->loads = 0;
+
+	return 1;
+}
+
+// Registers a profile written as "name=fileName"
+// Returns 0 if spec has no '=' or either side is empty, 1 for success
+int ProfileRegistry::addProfile(const string& spec)
+{
+	size_t	split = spec.find('=');
+
+
+	if (split == string::npos)
+	{
+		return 0;
+	}
+
+	return addProfile(spec.substr(0, split), spec.substr(split + 1));
+}
+
+
+
+// Sets corpus to the corpus of profile name, loading it first if it isn't loaded (nullptr unless 1 is returned)
+// Returns 0 if there is no such profile, -1 if its file couldn't be loaded (after displaying why), 1 for success
+int ProfileRegistry::acquire(const string& name, shared_ptr<RandomWord>& corpus)
+{
+	map<string, Profile>::iterator		found;
+	promise<shared_ptr<RandomWord>>		loader;		// Fulfilled by this call if it is the one loading
+	shared_future<shared_ptr<RandomWord>>	loading;	// The load this call waits on
+	string					fileName;
+	int					fileNumber = 0;
+	bool					loadHere = false;
+
+
+	corpus.reset();
+	{
+		lock_guard<mutex>	hold(_lock);
+
+		found = _profiles.find(name);
+		if (found == _profiles.end())
+		{
+			return 0;
+		}
+
+		if (found->second.corpus != nullptr)
+		{
+			_recent.splice(_recent.begin(), _recent, found->second.recent);
+			corpus = found->second.corpus;
+			return 1;
+		}
+
+		// The first caller loads the corpus, the rest wait for it
+		if (!found->second.loading.valid())
+		{
+			found->second.loading = loader.get_future().share();
+			fileName = found->second.fileName;
+			fileNumber = found->second.fileNumber;
+			loadHere = true;
+		}
+		loading = found->second.loading;
+	}
+
+	if (loadHere)
+	{
+		// A load that throws (such as bad_alloc on a large corpus) fails like any other, so the waiters
+		// get nullptr and the next acquire() tries again instead of finding a broken promise
+		try
+		{
+			corpus = make_shared<RandomWord>(fileName, 0);
+		}
+		catch (const exception& error)
+		{
+			cerr << "Error! Profile " << name << " couldn't load " << fileName << ": " << error.what() << endl;
+			corpus.reset();
+		}
+		if ((corpus != nullptr) && (corpus->listSize() == 0))
+		{
+			corpus.reset();
+		}
+
+		{
+			lock_guard<mutex>	hold(_lock);
+			finishLoad(name, fileNumber, corpus);
+		}
+		loader.set_value(corpus);
+	}
+	else
+	{
+		corpus = loading.get();
+	}
+
+	return (corpus != nullptr) ? 1 : -1;
+}
+
+
+
+// Returns the number of registered profiles
+int ProfileRegistry::profileCount()
+{
+	lock_guard<mutex>	hold(_lock);
+
+	return (int)_profiles.size();
+}
+
+// Displays every profile, whether it is loaded, and its bytes
+void ProfileRegistry::displayReport()
+{
+	lock_guard<mutex>			hold(_lock);
+	map<string, Profile>::iterator		i;
+
+
+	headerBox("Profiles");
+	for (i = _profiles.begin(); i != _profiles.end(); ++i)
+	{
+		cout << i->first << " (" << i->second.fileName << "): ";
+		if (i->second.corpus != nullptr)
+		{
+			cout << "loaded, " << i->second.bytes << " bytes";
+		}
+		else if (i->second.loading.valid())
+		{
+			cout << "loading";
+		}
+		else
+		{
+			cout << "not loaded";
+		}
+		cout << ", loaded " << i->second.loads << " times" << endl;
+	}
+	cout << "Loaded bytes:       " << _loadedBytes;
+	if (_memoryCap > 0)
+	{
+		cout << " of " << _memoryCap;
+	}
+	cout << endl;
+}
+
+
+
+// Keeps corpus (nullptr if it failed) as the loaded corpus of profile name, unless the name was pointed at another file since fileNumber
+// Must be called with _lock held
+void ProfileRegistry::finishLoad(const string& name, const int& fileNumber, const shared_ptr<RandomWord>& corpus)
+{
+	Profile&	profile = _profiles[name];
+	MemoryStats	stats;
+
+
+	if (profile.fileNumber != fileNumber)
+	{
+		return;
+	}
+
+	// A failed load is forgotten, so the next acquire() tries the file again
+	profile.loading = shared_future<shared_ptr<RandomWord>>();
+	if (corpus == nullptr)
+	{
+		return;
+	}
+
+	corpus->memoryStats(stats);
+	profile.corpus = corpus;
+	profile.bytes = stats.totalBytes;
+	++profile.loads;
+
+	_recent.push_front(name);
+	profile.recent = _recent.begin();
+	_loadedBytes += profile.bytes;
+
+	evict(name);
+}
+
+// Drops the least recently used corpora, never keep, until the loaded corpora fit in _memoryCap
+// Must be called with _lock held
+void ProfileRegistry::evict(const string& keep)
+{
+	Profile*	oldest;
+
+
+	while ((_memoryCap > 0) && (_loadedBytes > _memoryCap) && (_recent.size() > 1) && (_recent.back() != keep))
+	{
+		oldest = &_profiles[_recent.back()];
+		_loadedBytes -= oldest->bytes;
+		oldest->corpus.reset();
+		oldest->bytes = 0;
+		_recent.pop_back();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+#include "randomWord.h"
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+
+// Named corpora, each loaded the first time it is used
+//
+// A profile maps a name (such as "pharma" or "gaming") to a .txt word list or a model file.
+// Loaded corpora are kept in least recently used order, and once their memoryStats() total passes
+// the cap the least recently used ones are dropped. acquire() hands out shared ownership, so a
+// corpus dropped while generators still borrow it is only freed once the last of them lets go.
+// A corpus is loaded by the first caller to ask for it, outside the registry's lock, so other
+// profiles stay usable meanwhile; later callers for the same profile wait for that one load.
+class ProfileRegistry
+{
+public:
+	// Constructor
+	// memoryCap is the most bytes the loaded corpora may use together (0 for no limit)
+	explicit ProfileRegistry(const long& memoryCap);
+	//
+	// Each profile keeps its place in this registry's _recent list, so a registry can't be copied
+	ProfileRegistry(const ProfileRegistry&) = delete;
+	ProfileRegistry& operator=(const ProfileRegistry&) = delete;
+
+	// Registers profile name for fileName without loading it (a name added again points at the new file)
+	// Returns 0 if name or fileName is empty, 1 for success
+	int addProfile(const string& name, const string& fileName);
+	//
+	// Registers a profile written as "name=fileName"
+	// Returns 0 if spec has no '=' or either side is empty, 1 for success
+	int addProfile(const string& spec);
+
+	// Sets corpus to the corpus of profile name, loading it first if it isn't loaded (nullptr unless 1 is returned)
+	// Callers generate with their own RandomWord(const RandomWord*) borrowing it, so no word is made under the registry's lock
+	// Returns 0 if there is no such profile, -1 if its file couldn't be loaded (after displaying why), 1 for success
+	int acquire(const string& name, shared_ptr<RandomWord>& corpus);
+
+	// Returns the number of registered profiles
+	int profileCount();
+	//
+	// Displays every profile, whether it is loaded, and its bytes
+	void displayReport();
+
+private:
+	// One registered profile
+	struct Profile
+	{
+		string					fileName;	// Word list or model file
+		shared_ptr<RandomWord>			corpus;		// The loaded corpus (nullptr until first used or after eviction)
+		shared_future<shared_ptr<RandomWord>>	loading;	// The load in progress, for other callers to wait on (empty otherwise)
+		int					fileNumber;	// Counts addProfile() calls for the name, so a load of a replaced file is dropped
+		long					bytes;		// memoryStats() total of corpus
+		list<string>::iterator			recent;		// Place in _recent while loaded
+		int					loads;		// Times the corpus has been loaded
+	};
+
+	map<string, Profile>	_profiles;	// Every profile by name
+	list<string>		_recent;	// Loaded profiles, most recently used first
+	long			_memoryCap;	// Most bytes the loaded corpora may use together (0 for no limit)
+	long			_loadedBytes;	// Bytes the loaded corpora use together
+	mutex			_lock;		// Guards everything above
+
+
+
+	// Keeps corpus (nullptr if it failed) as the loaded corpus of profile name, unless the name was pointed at another file since fileNumber
+	// Must be called with _lock held
+	void finishLoad(const string& name, const int& fileNumber, const shared_ptr<RandomWord>& corpus);
+	//
+	// Drops the least recently used corpora, never keep, until the loaded corpora fit in _memoryCap
+	// Must be called with _lock held
+	void evict(const string& keep);
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "selfTest.h"
+#include "profileRegistry.h"
+#include <thread>
+
+using namespace std;
+
+// PROFILE REGISTRY TEST SETTINGS
+const int REGISTRY_TEST_THREADS = 6;		// Callers asking for one profile at once
+
+
+
+// Checks registering profiles, and acquiring unknown and unloadable ones
+static void testRegistering(const string& fileName)
+{
+	ProfileRegistry		registry(0);
+	shared_ptr<RandomWord>	corpus;
+
+
+	selfCheck((registry.addProfile("words=" + fileName) == 1) && (registry.addProfile("bad", selfTestPath("missing.txt")) == 1),
+		"profiles are registered by name and by name=file");
+	selfCheck((registry.addProfile("nofile") == 0) && (registry.addProfile("=" + fileName) == 0) && (registry.addProfile("empty=") == 0)
+		&& (registry.profileCount() == 2), "a spec without both a name and a file is refused");
+
+	selfCheck((registry.acquire("unknown", corpus) == 0) && (corpus == nullptr), "an unknown profile is reported");
+	selfCheck((registry.acquire("bad", corpus) == -1) && (corpus == nullptr), "a profile whose file can't be loaded is reported, not fatal");
+	selfCheck((registry.acquire("bad", corpus) == -1) && (corpus == nullptr), "a failed load is forgotten, so acquiring again tries the file again");
+	selfCheck((registry.acquire("words", corpus) == 1) && (corpus != nullptr) && (corpus->listSize() == SELF_TEST_WORDS),
+		"a profile is loaded when first acquired");
+
+	// Pointing the bad name at a good file fixes it
+	registry.addProfile("bad", fileName);
+	selfCheck(registry.acquire("bad", corpus) == 1, "a profile pointed at a new file loads the new file");
+}
+
+// Checks that callers asking at once share one load, and generate on their own borrowers
+static void testConcurrentCallers(const string& fileName)
+{
+	ProfileRegistry		registry(0);
+	shared_ptr<RandomWord>	corpora[REGISTRY_TEST_THREADS];
+	int			made[REGISTRY_TEST_THREADS] = { 0 };
+	vector<thread>		callers;
+	bool			shared = true;
+	bool			generated = true;
+	int			i;
+
+
+	registry.addProfile("words", fileName);
+	for (i = 0; i < REGISTRY_TEST_THREADS; ++i)
+	{
+		callers.push_back(thread([&registry, &corpora, &made, i]()
+		{
+			int	j;
+
+			if (registry.acquire("words", corpora[i]) == 1)
+			{
+				RandomWord	aRandomWord(corpora[i].get());
+
+				for (j = 0; j < 1000; ++j)
+				{
+					made[i] += (aRandomWord.generate() != 0);
+				}
+			}
+		}));
+	}
+	for (i = 0; i < REGISTRY_TEST_THREADS; ++i)
+	{
+		callers[i].join();
+		shared &= (corpora[i] != nullptr) && (corpora[i] == corpora[0]);
+		generated &= (made[i] == 1000);
+	}
+
+	selfCheck(shared, "callers acquiring a profile at once all get the one corpus loaded for them");
+	selfCheck(generated, "every caller generates on its own borrower");
+}
+
+// Checks that the least recently used profile is dropped past the cap, and kept alive while still held
+static void testEviction(const string& fileName)
+{
+	RandomWord		sizer(fileName, 0);
+	MemoryStats		stats;
+	shared_ptr<RandomWord>	first;
+	shared_ptr<RandomWord>	second;
+	shared_ptr<RandomWord>	again;
+
+
+	// Room for one corpus and a half, so loading a second drops the first
+	sizer.memoryStats(stats);
+	ProfileRegistry		registry(stats.totalBytes * 3 / 2);
+
+	registry.addProfile("first", fileName);
+	registry.addProfile("second", fileName);
+	registry.acquire("first", first);
+	registry.acquire("second", second);
+	registry.acquire("second", again);
+	selfCheck((again == second) && (first != second), "a loaded profile is handed out again without loading");
+
+	registry.acquire("first", again);
+	selfCheck((again != nullptr) && (again != first), "the least recently used profile is dropped and reloaded past the cap");
+	selfCheck((first->listSize() == SELF_TEST_WORDS) && (RandomWord(first.get()).generate() != 0), "a dropped corpus still works for those holding it");
+}
+
+
+
+// Loading, sharing, and eviction of named corpora
+void testProfileRegistry()
+{
+	string	fileName = selfTestPath("profiles.txt");
+
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the profile corpus"))
+	{
+		testRegistering(fileName);
+		testConcurrentCallers(fileName);
+		testEviction(fileName);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "pronounce.h"
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+PronounceScorer::PronounceScorer()
+{
+	int	i;
+
+	for (i = 0; i < PRONOUNCE_SYMBOLS * PRONOUNCE_SYMBOLS; ++i)
+	{
+		_logProbability[i] = 0;
+	}
+	_allowedRun = MAX_CHAR;
+}
+
+
+
+// Learns letter pair probabilities and the allowed consonant run from every donor word of corpus
+// Returns 0 if corpus has no donor words, 1 for success
+int PronounceScorer::train(const RandomWord& corpus)
+{
+	vector<long long>	pairCounts(PRONOUNCE_SYMBOLS * PRONOUNCE_SYMBOLS, 0);
+	vector<long long>	runCounts(MAX_CHAR + 1, 0);	// Consonant runs of each length
+	long long		totalRuns = 0;
+	long long		coveredRuns = 0;
+	long long		rowCount;
+	const char*		word;
+	int			before;
+	int			symbol;
+	int			run;
+	int			listIndex;
+	int			i;
+
+
+	if (corpus.listSize() == 0)
+	{
+		return 0;
+	}
+
+	for (listIndex = 0; listIndex < corpus.listSize(); ++listIndex)
+	{
+		word = corpus.donorWord(listIndex);
+		before = PRONOUNCE_SYMBOLS - 1;
+		run = 0;
+
+		// Count every pair, including start-to-first and last-to-end
+		for (i = 0; ; ++i)
+		{
+			symbol = letterIndex(word[i]);
+			++pairCounts[before * PRONOUNCE_SYMBOLS + symbol];
+
+			if (isConsonantIndex(symbol))
+			{
+				++run;
+			}
+			else if (run > 0)
+			{
+				++runCounts[min(run, MAX_CHAR)];
+				++totalRuns;
+				run = 0;
+			}
+
+			if (word[i] == '\0')
+			{
+				break;
+			}
+			before = symbol;
+		}
+	}
+
+	// Laplace smoothing keeps pairs the donors never use finite, just very unlikely
+	for (before = 0; before < PRONOUNCE_SYMBOLS; ++before)
+	{
+		rowCount = 0;
+		for (symbol = 0; symbol < PRONOUNCE_SYMBOLS; ++symbol)
+		{
+			rowCount += pairCounts[before * PRONOUNCE_SYMBOLS + symbol];
+		}
+		for (symbol = 0; symbol < PRONOUNCE_SYMBOLS; ++symbol)
+		{
+			_logProbability[before * PRONOUNCE_SYMBOLS + symbol] =
+				(float)log((pairCounts[before * PRONOUNCE_SYMBOLS + symbol] + 1.0) / (rowCount + PRONOUNCE_SYMBOLS));
+		}
+	}
+
+	// The allowed run is the shortest one that covers nearly every run the donors use
+	_allowedRun = 1;
+	for (run = 1; run <= MAX_CHAR; ++run)
+	{
+		coveredRuns += runCounts[run];
+		_allowedRun = run;
+		if (coveredRuns >= totalRuns * PRONOUNCE_RUN_COVERAGE)
+		{
+			break;
+		}
+	}
+
+	return 1;
+}
+
+
+
+// Fills in batch.scores() for every word of the batch
+// Works one letter position at a time across the whole batch, so the inner loop has no branches
+void PronounceScorer::scoreBatch(WordBatch& batch) const
+{
+	const int		words = batch.size();
+	const unsigned char*	lengths = batch.lengths();
+	float*			scores = batch.scores();
+	vector<int>		before(words, PRONOUNCE_SYMBOLS - 1);	// Symbol before the current position of each word
+	vector<int>		runs(words, 0);				// Consonant run ending at the current position of each word
+	vector<int>		excess(words, 0);			// Consonants past _allowedRun so far in each word
+	const char*		letters;
+	int			position;
+	int			symbol;
+	int			active;
+	int			w;
+
+
+	for (w = 0; w < words; ++w)
+	{
+		scores[w] = 0;
+	}
+
+	// Position maxLength() is the extra '\0' row, which gives every word its end-of-word pair
+	for (position = 0; position <= batch.maxLength(); ++position)
+	{
+		letters = batch.letters(position);
+
+		for (w = 0; w < words; ++w)
+		{
+			// Words that have already ended add nothing
+			active = (position <= lengths[w]);
+			symbol = letterIndex(letters[w]);
+
+			scores[w] += active * _logProbability[before[w] * PRONOUNCE_SYMBOLS + symbol];
+			runs[w] = isConsonantIndex(symbol) * (runs[w] + 1);
+			excess[w] += active * (runs[w] > _allowedRun);
+			before[w] = symbol;
+		}
+	}
+
+	for (w = 0; w < words; ++w)
+	{
+		scores[w] = (scores[w] / (lengths[w] + 1)) - (PRONOUNCE_RUN_PENALTY * excess[w]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include "randomWord.h"
+#include "wordBatch.h"
+
+
+// PRONOUNCEABILITY SETTINGS
+const int PRONOUNCE_SYMBOLS = LETTER_COUNT + 1;	// letterIndex() of each char: 'a'-'z' without regard to case, then LETTER_NONE for the start or end of a word
+const double PRONOUNCE_RUN_COVERAGE = 0.999;	// A consonant run is allowed if at least this share of donor runs are as short
+const float PRONOUNCE_RUN_PENALTY = 2.0f;	// Score taken away for each consonant past the allowed run
+
+
+// Scores how pronounceable words are, using statistics learned from the donor words
+//
+// A word's score is the average log-probability of each letter given the one before it
+// (counting the start and end of the word as letters), less a penalty for every consonant
+// past the longest consonant run the donor words commonly use. Higher is more pronounceable.
+class PronounceScorer
+{
+public:
+	// Constructor
+	// Scores every word the same until train() is called
+	PronounceScorer();
+
+	// Learns letter pair probabilities and the allowed consonant run from every donor word of corpus
+	// Returns 0 if corpus has no donor words, 1 for success
+	int train(const RandomWord& corpus);
+
+	// Fills in batch.scores() for every word of the batch
+	// Works one letter position at a time across the whole batch, so the inner loop has no branches
+	void scoreBatch(WordBatch& batch) const;
+
+private:
+	float	_logProbability[PRONOUNCE_SYMBOLS * PRONOUNCE_SYMBOLS];	// log P(letter | letter before), indexed [before * PRONOUNCE_SYMBOLS + letter]
+	int	_allowedRun;							// Longest consonant run that is not penalized
+
+};
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "selfTest.h"
+#include "pronounce.h"
+
+using namespace std;
+
+// Scores the words of words with scorer, one batch for all of them
+// Returns the score of every word, in order
+static vector<float> scoreWords(const PronounceScorer& scorer, const vector<string>& words)
+{
+	WordBatch	batch((int)words.size(), LARGEST_WORD);
+	size_t		i;
+
+
+	for (i = 0; i < words.size(); ++i)
+	{
+		batch.add(words[i].c_str());
+	}
+	scorer.scoreBatch(batch);
+
+	return vector<float>(batch.scores(), batch.scores() + batch.size());
+}
+
+// Checks that words shaped like the donor words outscore ones that aren't, whatever else is in their batch
+static void testScoring(const RandomWord& corpus)
+{
+	PronounceScorer	scorer;
+	vector<float>	untrained;
+	vector<float>	mixed;
+	vector<float>	alone;
+
+
+	untrained = scoreWords(scorer, { "bacedo", "xqkxqz" });
+	selfCheck(untrained[0] == untrained[1], "an untrained scorer scores every word the same");
+
+	selfCheck(scorer.train(corpus) == 1, "a scorer trains on the corpus");
+
+	// The test corpus alternates consonants and vowels and never uses q or x
+	mixed = scoreWords(scorer, { "xqkxqz", "bacedo", "ab", "dofuvaliremo" });
+	selfCheck((mixed[1] > mixed[0]) && (mixed[3] > mixed[0]), "words shaped like the donor words score higher");
+
+	// Each word's letters are scored in its own lane, so its neighbours can't change its score
+	alone = scoreWords(scorer, { "bacedo" });
+	selfCheck(alone[0] == mixed[1], "a word scores the same alone as among longer and shorter words");
+}
+
+// Checks that keepTop() and keepWhere() keep the right words in their original order
+static void testKeeping()
+{
+	WordBatch	batch(8, LARGEST_WORD);
+	const char*	words[] = { "aa", "bbb", "c", "dddd", "ee" };
+	unsigned char	keep[] = { 1, 0, 1, 0, 1 };
+	char		buffer[LARGEST_WORD + 1];
+	int		i;
+
+
+	for (i = 0; i < 5; ++i)
+	{
+		batch.add(words[i]);
+		batch.scores()[i] = (float)(i % 3);
+	}
+
+	// Scores 0 1 2 0 1: the best 3 are "bbb", "c", and "ee"
+	selfCheck(batch.keepTop(0.6) == 3, "keepTop() keeps its share of the batch");
+	batch.copyWord(0, buffer);
+	selfCheck(!strcmp(buffer, "bbb"), "keepTop() keeps the highest scores in their original order");
+	batch.copyWord(2, buffer);
+	selfCheck((!strcmp(buffer, "ee")) && (batch.lengths()[2] == 2), "a kept word keeps its length");
+
+	batch.clear();
+	for (i = 0; i < 5; ++i)
+	{
+		batch.add(words[i]);
+	}
+	batch.keepWhere(keep);
+	batch.copyWord(1, buffer);
+	selfCheck((batch.size() == 3) && (!strcmp(buffer, "c")), "keepWhere() keeps the marked words in their original order");
+	selfCheck(batch.add(string(LARGEST_WORD + 1, 'a').c_str()) == 0, "a word longer than the batch allows is refused");
+}
+
+
+
+// PronounceScorer scoring and WordBatch filtering
+void testPronounce()
+{
+	string	fileName = selfTestPath("pronounce.txt");
+
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the pronounce corpus"))
+	{
+		RandomWord	corpus(fileName, 0);
+
+		testScoring(corpus);
+	}
+	remove(fileName.c_str());
+
+	testKeeping();
+}
\ No newline at end of file
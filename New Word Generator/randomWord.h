@@ -1,38 +1,221 @@
+#pragma once
 #include "utilities.h"
+#include "successorIndex.h"
+#include "modelFile.h"
+#include "blocklist.h"
+#include "wordLength.h"
+#include "letterSampler.h"
+#include "startupTrace.h"
+#include "runMetrics.h"
+#include <memory>
+#include <mutex>
+#include <vector>
 
 
 // WORD SIZE SETTINGS
-// Range of word sizes that can be randomly generated
+// Range of word sizes randomly generated when no LengthDistribution is set
 const int SMALLEST_WORD = 2;	// Smallest possible word generated (do not set below 2)
-const int LARGEST_WORD = 12;	// Largest possible word generated (do not set above 255)
+const int LARGEST_WORD = 12;	// Largest possible word generated (do not set above LONGEST_LENGTH)
+
+// DONOR MEMBERSHIP SETTINGS
+// Markers for the open-addressing table that finds a donor word's position in Corpus::offsets
+const int EMPTY_SLOT = -1;	// The slot has never held a word
+const int REMOVED_SLOT = -2;	// The slot held a word that has since been removed
+const int SLOT_HEADROOM = 4;	// A table rebuilt to make room for a new word gets this many slots per donor word
+const int COMPACT_MIN_BYTES = 4096;	// Arena chars of removed words tolerated before the arena is compacted
+
+
+// DONOR CORPUS
+// The donor words and the indexes built from them. Generators hold it through a shared_ptr (see RandomWord::_corpus),
+// and it is never changed while another generator holds it: updates copy it first and swap the copy in
+struct Corpus
+{
+	int*		offsets;		// The donor list: where each donor word starts in arena
+	int		listSize;		// The number of donor words, and of entries used in offsets
+	int		listCapacity;		// The number of entries allocated in offsets
+	char*		arena;			// One block holding every donor word, each after a length byte and before a null
+	int		arenaSize;		// The number of chars allocated in arena
+	int		arenaUsed;		// The number of chars of arena holding words, removed ones included
+	int		deadBytes;		// The chars of arena still holding removed words, until compactArena() reclaims them
+	int*		slots;			// Open-addressing table of donor list indices, keyed on the hash of each word
+	int		slotCount;		// The number of entries in slots (always a power of 2)
+	int		slotsUsed;		// The number of entries in slots that are not EMPTY_SLOT
+	SuccessorIndex	successorIndex;		// Which letters each third of the donor words can supply after each letter
+	int		sampleStride;		// Only every sampleStride-th line of the .txt file was loaded (1 loads every line)
+	const char*	mappedModel;		// The start of the model file the arrays above point into (nullptr if they are on the heap)
+	long long	mappedBytes;		// The size of mappedModel
+
+	// Starts empty, with nothing allocated
+	Corpus();
+	//
+	// Frees the arrays, or unmaps the model file they point into
+	~Corpus();
+	//
+	// The arrays are freed by the destructor, so a Corpus is shared through a shared_ptr instead of copied
+	Corpus(const Corpus&) = delete;
+	Corpus& operator=(const Corpus&) = delete;
+};
+
+
+// MEMORY ACCOUNTING
+// Bytes held by each part of a RandomWord, filled in by RandomWord::memoryStats()
+struct MemoryStats
+{
+	long	arenaBytes;		// Corpus::arena, every donor word with its length and null
+	long	offsetBytes;		// Corpus::offsets, where each donor word starts in the arena
+	long	slotBytes;		// Corpus::slots, the membership table
+	long	indexBytes;		// Corpus::successorIndex, the letter successor counts
+	long	scratchBytes;		// _randomWord, the per-generator word buffer
+	long	totalBytes;		// Sum of all of the above
+	long	sharedBytes;		// Part of totalBytes mapped from a model file or shared with other generators
+	int	sampleStride;		// 1 if every word was loaded, n if only every nth word was kept to fit the memory cap
+};
 
 
 class RandomWord
 {
 public:
 	// Constructor
-	// All word generation occurs in the constructor
+	// Loads the donor words from words.txt and generates a first word (see generate() for more)
 	RandomWord();
 	//
+	// Loads the donor words from fileName instead of words.txt
+	// fileName may be a .txt word list or a model file written by saveModel(), which is mapped instead of read
+	// When memoryCap is above 0 (bytes), only every nth word of a .txt file is loaded so the corpus fits under the cap,
+	// and no word is loaded if the cap is below what the corpus needs before its first word
+	// A file that can't be read or used is reported and leaves listSize() at 0, so check it before generating
+	RandomWord(const string& fileName, const long& memoryCap);
+	//
+	// Shares the donor list of corpusOwner instead of loading one, so each thread can have its own generator
+	// This RandomWord keeps the donor list as it was when constructed: words corpusOwner adds or removes later
+	// are not seen here, and corpusOwner may be destroyed first
+	// With firstWord false no word is generated until generate() is called, so word() is nullptr and
+	// constructing takes no generation time, which a caller bounding every word with a work budget needs
+	explicit RandomWord(const RandomWord* corpusOwner, const bool& firstWord = true);
+	//
 	// Destructor
 	~RandomWord();
 
 	// Displays the random word
 	int display() const;
 
+	// Generates a new random word from the already loaded donor list
+	// workBudget is the most donor words that may be examined for the whole word (0 for no limit)
+	// Without a budget each letter after the first examines at most listSize() donor words before falling back to a vowel,
+	// so a word of length L examines at most (L - 1) * listSize() (times BLOCKLIST_RETRIES + 1 with a blocklist)
+	// Returns 0 for failure, 1 for success, 2 if the budget ran out and the remaining letters were filled with vowels
+	// With a blocklist set, blocked words are replaced, and 0 is returned if BLOCKLIST_RETRIES replacements are all blocked
+	int generate(const int& workBudget = 0);
+	//
+	// Returns the number of donor words examined while generating the current word
+	int donorPicks() const;
+	//
+	// Screens every generated word against blocklist, replacing the ones it blocks (nullptr screens nothing)
+	// blocklist is kept rather than copied, so it must outlive its use here
+	void setBlocklist(const Blocklist* blocklist);
+	//
+	// Returns the number of blocked words replaced by the last call to generate()
+	int rejectedWords() const;
+	//
+	// Draws the length of every word from lengths instead of uniformly from SMALLEST_WORD to LARGEST_WORD (nullptr restores that)
+	// lengths is kept rather than copied, like the blocklist of setBlocklist()
+	void setLengthDistribution(const LengthDistribution* lengths);
+	//
+	// Returns the word generated last, or nullptr if there isn't one
+	const char* word() const;
+	//
+	// Restarts this generator's random number sequence from seedValue
+	void seed(const unsigned long long& seedValue);
+	//
+	// With reference true, fillSection() runs the original algorithm: no successor index shortcut, and donor lengths
+	// are counted instead of read from the arena. Only used to check optimizations against it (see verify.h)
+	void setReferenceMode(const bool& reference);
+	//
+	// Counts every letter fillSection() fills in, and every vowel fallback, into metrics (nullptr counts nothing)
+	// metrics must belong to the thread calling generate()
+	void setMetrics(ThreadMetrics* metrics);
+
+
+
+	// CORPUS UPDATES
+	//
+	// Adds a copy of word to the end of the donor list so later words can draw from it
+	// Takes time proportional to the word, unless the donor list is shared with another generator or a model file,
+	// in which case it is copied first so they keep the words they had
+	// Returns 0 if the word is empty, too long, or already in the list, 1 for success
+	int addDonorWord(const char word[]);
+	//
+	// Removes word from the donor list by moving the last entry into its place, copying the list first like addDonorWord()
+	// Returns 0 if the word is not in the list, 1 for success
+	int removeDonorWord(const char word[]);
+	//
+	// Returns the number of donor words currently in the donor list
+	int listSize() const;
+	//
+	// Check if word is in the donor list
+	// Returns true if it is
+	bool isDonorWord(const char word[]) const;
+	//
+	// Returns the donor word at listIndex (0 to listSize() - 1)
+	const char* donorWord(const int& listIndex) const;
+	//
+	// Returns the successor counts of the donor list, which fillSection() draws letters in proportion to
+	const SuccessorIndex& successorIndex() const;
+	//
+	// Returns the length of the donor word at listIndex, read from the arena instead of counted
+	int donorLength(const int& listIndex) const;
+
+
+
+	// MEMORY ACCOUNTING
+	//
+	// Fills stats with the bytes held by each part of this RandomWord
+	void memoryStats(MemoryStats& stats) const;
+	//
+	// Displays the memoryStats() breakdown
+	void displayMemoryReport() const;
+
+
+
+	// MODEL FILES
+	//
+	// Writes the loaded corpus, membership table, and successor index to fileName
+	// so other processes can map it with the fileName constructor
+	// Returns 0 for failure, 1 for success
+	int saveModel(const string& fileName) const;
+	//
+	// Check if a mapped model still matches its checksum and every donor word and membership slot can be used
+	// as it is, reading the whole file (mapping only checks the header and section bounds, see modelFile.h)
+	// Returns true if it does, or if the corpus isn't mapped from a model
+	bool modelIntact() const;
+
 private:
 	int		_wordLength;			// Length of the random word
 	int		_oneThird;			// 1/3 of the length of the random word (rounded down)
 	int		_lettersAdded;			// Number of letters that have been generated in the random word
 	char*		_randomWord;			// The pointer to the locaiton of the random word
-	const string    _fileName = "words.txt";	// The file name of the .txt file containing the database of donor words for the _donorWordList
-	int		_listSize;			// The number of lines in the incoming .txt file and size of the _donorWordList
-	char**		_donorWordList;			// The pointer to the location of the database list of donor words pulled from the .txt file
+	int		_wordCapacity;			// The number of chars allocated in _randomWord, kept between words
+	const string    _fileName;			// The file name of the .txt file (or model file) containing the database of donor words
+	const long	_memoryCap;			// The most bytes the corpus may use (0 for no limit)
+	shared_ptr<Corpus>	_corpus;		// The donor words, shared with every RandomWord constructed from this one
+	mutable mutex	_corpusLock;			// Held while _corpus is changed or swapped, and while it is shared with a new RandomWord
+	int		_workBudget;			// The most donor words fillSection() may examine for the current word (0 for no limit)
+	int		_donorPicks;			// The number of donor words examined for the current word
+	bool		_budgetExhausted;		// True once _donorPicks has reached _workBudget for the current word
+	const Blocklist*	_blocklist;		// Banned substrings screened out of every word (nullptr for none)
+	int		_rejectedWords;			// The number of blocked words replaced by the last call to generate()
+	const LengthDistribution*	_lengths;	// Where each word's length is drawn from (nullptr for SMALLEST_WORD to LARGEST_WORD)
+	unsigned long long	_rngState;		// This generator's own random number state, so generators on different threads don't share one
+	bool		_referenceMode;			// True to skip every shortcut in fillSection(), see setReferenceMode()
+	ThreadMetrics*	_metrics;			// Where fillSection() counts letters and fallbacks (nullptr for nowhere)
 
 
 
 	// CONSTRUCTOR & DESTRUCTOR SUPPORT
 	//
+	// Sets every member to its empty value before the corpus is loaded
+	void resetMembers();
+	//
 	// Calls the functions to build the random word
 	// returns 0 for failure, 1 for success
 	int initialize();
@@ -41,7 +224,7 @@ private:
 	// returns 0 for failure, 1 for success
 	int deleteWord();
 	//
-	// Deallocates the dynamic memory in _donorWordList
+	// Lets go of the donor list, which is freed or unmapped once no other RandomWord shares it
 	// returns 0 for failure, 1 for success
 	int deleteDonorList();
 
@@ -49,46 +232,104 @@ private:
 
 	// LOAD THE DATABASE
 	//
-	// Scan the incoming .txt file for the number of entries and allocates _donorWordList with that number of elements
-	// Returns the size of the _donorWordList
+	// Scan the incoming .txt file for the number of entries and allocates the donor list with that number of elements
+	// Picks the sample stride first when the full file would not fit in _memoryCap
+	// Returns the size of the donor list, or -1 if the file can't be read or _memoryCap can't hold even one word (after displaying why)
 	int allocateDonorList();
 	//
-	// Loads the entries from the incoming .txt file into the previously allocated _donorWordList
-	// Returns 0 if the file can't open, -1 if the file is empty, and 1 for success
+	// Reads the length of every word of the incoming .txt file into wordLengths, skipping empty lines
+	// Returns the number of words, or -1 if the file can't be read (after displaying why)
+	int countDonorFile(vector<unsigned char>& wordLengths);
+
+	//
+	// Returns the bytes the corpus will need to hold listSize words using arenaSize chars
+	long estimateCorpusBytes(const long& listSize, const long& arenaSize) const;
+	//
+	// Loads the entries from the incoming .txt file into the previously allocated arena and offsets of _corpus
+	// Returns 0 if the file can't open (setting the list size to -1), -1 if the file is empty, and 1 for success
 	int loadDB();
+	//
+	// Maps the model file _fileName and points the donor list at it
+	// Returns the size of the donor list, or -1 if the file can't be mapped or is not a usable model (after displaying why)
+	int mapModel();
+	//
+	// Copies _corpus into our own memory when a model file or another RandomWord shares it, so it can be changed
+	// Must be called with _corpusLock held
+	// Returns 0 for failure, 1 for success
+	int privatizeCorpus();
+	//
+	// Moves the donor words together in a new arena, dropping the chars of removed words
+	// Returns 0 for failure, 1 for success
+	int compactArena();
+
+
+
+	// DONOR MEMBERSHIP
+	//
+	// Returns the hash of a word used to place it in the membership table
+	unsigned int hashWord(const char word[]) const;
+	//
+	// Finds the slot in the membership table holding the index of word
+	// Returns the slot, or -1 if the word is not in the donor list
+	int findDonorSlot(const char word[]) const;
+	//
+	// Records the donor list index listIndex in the membership table
+	// When the table is half full it is rebuilt with SLOT_HEADROOM slots per word, so that the next rebuild is listSize() inserts away
+	// Returns 0 for failure, 1 for success
+	int insertDonorSlot(const int& listIndex);
+	//
+	// Reallocates the membership table with slotCount entries and re-inserts every word in the donor list
+	// Returns 0 for failure, 1 for success
+	int rebuildDonorSlots(const int& slotCount);
 
 
 
 	// RANDOM CHARACTER RETURNS
 	//
+	// Returns the next 32 random bits of this generator's own sequence (xorshift64*)
+	unsigned int nextRandom();
+	//
 	// Returns a random number between the bounds (inclusive)
-	int generateRandomNumber(const int& lowerBound, const int& upperBound) const;
+	int generateRandomNumber(const int& lowerBound, const int& upperBound);
 	//
 	// Returns a random lowercase letter
 	char generateRandomLetter();
 	//
 	// Returns a random lowercase vowel
 	char generateRandomVowel();
+	//
+	// Returns a word length drawn from _lengths, or from SMALLEST_WORD to LARGEST_WORD without one
+	int generateWordLength();
 
 
 
 	// WORD GENERATION
 	//
+	// Generates one word of random length into _randomWord
+	// Returns 0 for failure, 1 for success
+	int generateCandidate();
+	//
 	// Calls fillSection() with appropriate arguments
 	// Returns 0 for failure, 1 for success
 	int generateLetters();
 	//
 	// Generates a random two-letter word containing 1 lowercase vowel and 1 lowercase consonant in random order
-	// Returns 0 for failure, 1 for success
+	// Returns the number of letters generated
 	int generateTwoLetterWord();
 	//
 	// Fills letters into _randomWord based on the given functions which will provide the needed index bounds
+	// section is the matching row of the successor index (0 first, 1 middle, 2 last third)
+	// Each letter examines at most listSize() donor words, and never more than what is left of _workBudget
 	// Returns 0 for failure, 1 for success
-	int fillSection(void (RandomWord::*boundaryFunction)(int& upperBoundary), void (RandomWord::*donorBoundary)(int& donorLength, int& donorLower, int& donorUpper));
+	int fillSection(void (RandomWord::*boundaryFunction)(int& upperBoundary), void (RandomWord::*donorBoundary)(int& donorLength, int& donorLower, int& donorUpper), const int& section);
+	//
+	// Check if the work budget for the current word has been used up
+	// Returns true if no more donor words may be examined
+	bool budgetSpent();
 	//
 	// Check if argument character is an alpha
 	// Returns true if it is an alpha, or false if it is anything else
-	bool checkChar(char& aChar);
+	bool checkChar(const char& aChar);
 	//
 	//
 	// Gives index bounds for the first 1/3 of _randomWord (rounded down)
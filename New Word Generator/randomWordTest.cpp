@@ -0,0 +1,315 @@
+#include "selfTest.h"
+#include "randomWord.h"
+#include <chrono>
+#include <memory>
+
+using namespace std;
+
+// Checks that a word never examines more donor words than its budget, and that running out is reported
+static void testWorkBudget(RandomWord& aRandomWord)
+{
+	LengthDistribution	lengths;
+	bool			withinBudget = true;
+	int			exhausted = 0;
+	int			status;
+	int			i;
+
+
+	// Long words need the most donor picks, so some of them run out
+	lengths.setUniform(12, 12);
+	aRandomWord.setLengthDistribution(&lengths);
+	for (i = 0; i < 500; ++i)
+	{
+		status = aRandomWord.generate(5);
+		withinBudget &= (aRandomWord.donorPicks() <= 5) && (status != 0) && (strlen(aRandomWord.word()) == 12);
+		exhausted += (status == 2);
+	}
+	aRandomWord.setLengthDistribution(nullptr);
+
+	selfCheck(withinBudget, "generate(5) examines at most 5 donor words");
+	selfCheck(exhausted > 0, "generate(5) returns 2 when the budget runs out");
+}
+
+// Checks the bound generate() documents without a budget: at most listSize() donor words per letter after the first
+static void testUnbudgetedBound()
+{
+	string		fileName = selfTestPath("sparse.txt");
+	ofstream	out(fileName);
+	bool		withinBound = true;
+	int		mostPicks = 0;
+	int		i;
+
+
+	// Three donor words with few successors, so most letters use every try before falling back to a vowel
+	out << "abc\nqrs\nxyz\n";
+	out.close();
+
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		aRandomWord.setReferenceMode(true);
+		for (i = 0; i < 500; ++i)
+		{
+			aRandomWord.generate();
+			withinBound &= (aRandomWord.donorPicks() <= ((int)strlen(aRandomWord.word()) - 1) * aRandomWord.listSize());
+			mostPicks = max(mostPicks, aRandomWord.donorPicks());
+		}
+	}
+	remove(fileName.c_str());
+
+	selfCheck(withinBound, "an unbudgeted word examines at most (length - 1) * listSize() donor words");
+	selfCheck(mostPicks > 3, "a word can examine more than listSize() donor words in all");
+}
+
+
+
+// Checks that a memory cap is never exceeded: a small one samples the words, and one below the fixed overhead loads none
+static void testMemoryCap(const string& fileName)
+{
+	MemoryStats	full;
+	MemoryStats	stats;
+	long		memoryCap;
+
+
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		aRandomWord.memoryStats(full);
+		selfCheck((aRandomWord.listSize() == SELF_TEST_WORDS) && (full.sampleStride == 1), "every line of the corpus is loaded without a cap");
+	}
+
+	memoryCap = sizeof(SuccessorIndex) + (full.totalBytes - full.scratchBytes - (long)sizeof(SuccessorIndex)) / 3;
+	{
+		RandomWord	aRandomWord(fileName, memoryCap);
+
+		aRandomWord.memoryStats(stats);
+		selfCheck((stats.sampleStride > 1) && (stats.totalBytes - stats.scratchBytes <= memoryCap) && (aRandomWord.listSize() > 0),
+			"a memory cap samples the corpus to fit under it");
+	}
+
+	{
+		RandomWord	aRandomWord(fileName, 1000);
+
+		selfCheck((aRandomWord.listSize() == 0) && (aRandomWord.word() == nullptr), "a memory cap too small for any word loads none");
+	}
+}
+
+// Checks that empty lines, CRLF line endings, and lines longer than a donor word can be, are read as the loader documents
+static void testLoaderLines()
+{
+	string		fileName = selfTestPath("lines.txt");
+	ofstream	out(fileName);
+	bool		loaded;
+
+
+	out << "\n\nalpha\n\nbeta\n" << string(MAX_CHAR + 10, 'x') << "\ngamma";
+	out.close();
+
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		loaded = (aRandomWord.listSize() == 4) && (aRandomWord.isDonorWord("alpha")) && (aRandomWord.isDonorWord("gamma")) &&
+			(aRandomWord.isDonorWord(string(MAX_CHAR - 1, 'x').c_str()));
+	}
+	remove(fileName.c_str());
+
+	selfCheck(loaded, "empty lines are skipped and long lines cut to MAX_CHAR - 1 chars");
+
+	out.open(fileName, ios::binary);
+	out << "alpha\r\n\r\nbeta\r\n";
+	out.close();
+
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		loaded = (aRandomWord.listSize() == 2) && (aRandomWord.isDonorWord("alpha")) && (aRandomWord.isDonorWord("beta"));
+	}
+	remove(fileName.c_str());
+
+	selfCheck(loaded, "a corpus with CRLF line endings loads its words without the '\\r'");
+}
+
+// Returns a word of letters spelling number, for adding words the test corpus can't hold
+static string numberWord(int number)
+{
+	string	word = "qx";
+
+
+	do
+	{
+		word += (char)('a' + number % 26);
+		number /= 26;
+	} while (number > 0);
+
+	return word;
+}
+
+// Checks what addDonorWord() and removeDonorWord() accept, and that the membership table follows them
+static void testDonorUpdates(RandomWord& aRandomWord)
+{
+	string	first = aRandomWord.donorWord(0);
+	int	listSize = aRandomWord.listSize();
+	bool	updated;
+
+
+	selfCheck(aRandomWord.addDonorWord("") == 0, "addDonorWord() refuses an empty word");
+	selfCheck(aRandomWord.addDonorWord(first.c_str()) == 0, "addDonorWord() refuses a word already in the list");
+
+	updated = (aRandomWord.addDonorWord("qxzzy") == 1) && (aRandomWord.isDonorWord("qxzzy")) && (aRandomWord.listSize() == listSize + 1);
+	selfCheck(updated, "addDonorWord() adds a new word");
+
+	updated = (aRandomWord.removeDonorWord(first.c_str()) == 1) && (!aRandomWord.isDonorWord(first.c_str())) &&
+		(aRandomWord.removeDonorWord(first.c_str()) == 0) && (aRandomWord.isDonorWord("qxzzy"));
+	selfCheck(updated, "removeDonorWord() removes a word once and keeps the word moved into its place");
+
+	aRandomWord.removeDonorWord("qxzzy");
+	aRandomWord.addDonorWord(first.c_str());
+	selfCheck(aRandomWord.listSize() == listSize, "the list is back to its size after undoing both");
+}
+
+// Checks that a generator borrowing a donor list keeps it as it was, however its owner changes or ends
+static void testSnapshots(const string& fileName)
+{
+	unique_ptr<RandomWord>	owner(new RandomWord(fileName, 0));
+	RandomWord		borrower(owner.get());
+	string			first = owner->donorWord(0);
+	int			listSize = owner->listSize();
+	MemoryStats		stats;
+	bool			generated = true;
+	int			i;
+
+
+	borrower.memoryStats(stats);
+	selfCheck(stats.sharedBytes > 0, "a borrower reports its donor list as shared");
+
+	// Enough words to regrow the owner's arrays, which a borrower pointing into them would not survive
+	for (i = 0; i < listSize; ++i)
+	{
+		owner->addDonorWord(numberWord(i).c_str());
+	}
+	owner->removeDonorWord(first.c_str());
+
+	selfCheck((owner->listSize() == 2 * listSize - 1) && (!owner->isDonorWord(first.c_str())), "the owner sees its own updates");
+	selfCheck((borrower.listSize() == listSize) && (borrower.donorWord(0) == first) && (!borrower.isDonorWord("qxa")),
+		"a borrower keeps the donor list it was constructed with");
+
+	owner.reset();
+	for (i = 0; i < 1000; ++i)
+	{
+		generated &= (borrower.generate() != 0);
+	}
+	selfCheck(generated && borrower.isDonorWord(first.c_str()), "a borrower still generates after its owner is destroyed");
+}
+
+// Checks that alternating updates on a list of a power of two words stay cheap (the membership table rebuilt
+// to exactly half full used to rebuild again on every following insert, costing milliseconds per update)
+static void testUpdateCost()
+{
+	string		fileName = selfTestPath("power.txt");
+	chrono::steady_clock::time_point	start;
+	double		seconds;
+	int		i;
+
+
+	if (!selfCheck(writeTestCorpus(fileName, 65536, SELF_TEST_SEED) != 0, "write a corpus of 65536 words"))
+	{
+		return;
+	}
+
+	{
+		RandomWord	aRandomWord(fileName, 0);
+		string		word = aRandomWord.donorWord(0);
+		int		listSize = aRandomWord.listSize();
+
+		start = chrono::steady_clock::now();
+		for (i = 0; i < 1000; ++i)
+		{
+			aRandomWord.removeDonorWord(word.c_str());
+			aRandomWord.addDonorWord(word.c_str());
+		}
+		seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		selfCheck(aRandomWord.listSize() == listSize, "alternating updates keep the list size");
+		selfCheck(seconds < 0.25, "1000 remove/add pairs on 65536 words take well under a second");
+	}
+	remove(fileName.c_str());
+}
+
+// Checks that words removed over and over don't grow the arena without bound
+static void testArenaChurn(RandomWord& aRandomWord)
+{
+	MemoryStats	stats;
+	long		firstArena;
+	long		largestArena = 0;
+	int		listSize = aRandomWord.listSize();
+	string		word;
+	bool		consistent = true;
+	int		i;
+
+
+	aRandomWord.memoryStats(stats);
+	firstArena = stats.arenaBytes;
+
+	// Each removed word leaves its chars behind until the arena is compacted
+	for (i = 0; i < 20 * SELF_TEST_WORDS; ++i)
+	{
+		word = aRandomWord.donorWord(i % listSize);
+		aRandomWord.removeDonorWord(word.c_str());
+		aRandomWord.addDonorWord(word.c_str());
+
+		aRandomWord.memoryStats(stats);
+		largestArena = max(largestArena, stats.arenaBytes);
+	}
+
+	for (i = 0; i < aRandomWord.listSize(); ++i)
+	{
+		consistent &= aRandomWord.isDonorWord(aRandomWord.donorWord(i)) && ((int)strlen(aRandomWord.donorWord(i)) == aRandomWord.donorLength(i));
+	}
+
+	selfCheck(largestArena <= 3 * firstArena, "the arena stays within 3 times its loaded size under churn");
+	selfCheck(consistent && (aRandomWord.listSize() == listSize), "every donor word survives compaction");
+}
+
+// Checks that a mapped model is copied before it is changed
+static void testModelUpdates(RandomWord& aRandomWord)
+{
+	string	fileName = selfTestPath("model.rwm");
+
+
+	if (selfCheck(aRandomWord.saveModel(fileName) != 0, "save a model"))
+	{
+		RandomWord	mapped(fileName, 0);
+		RandomWord	borrower(&mapped);
+
+		selfCheck((mapped.addDonorWord("qxzzy") == 1) && (mapped.isDonorWord("qxzzy")) && (mapped.listSize() == aRandomWord.listSize() + 1),
+			"a mapped model takes new words");
+		selfCheck((borrower.listSize() == aRandomWord.listSize()) && (!borrower.isDonorWord("qxzzy")), "a borrower of a mapped model keeps its words");
+	}
+	remove(fileName.c_str());
+}
+
+
+
+// RandomWord generation, work budgets, and corpus updates
+void testRandomWord()
+{
+	string	fileName = selfTestPath("corpus.txt");
+
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the test corpus"))
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		testMemoryCap(fileName);
+		testWorkBudget(aRandomWord);
+		testDonorUpdates(aRandomWord);
+		testModelUpdates(aRandomWord);
+		testArenaChurn(aRandomWord);
+		testSnapshots(fileName);
+	}
+	remove(fileName.c_str());
+
+	testUnbudgetedBound();
+	testLoaderLines();
+	testUpdateCost();
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "runMetrics.h"
+#include <filesystem>
+
+using namespace std;
+
+RunMetrics::RunMetrics(const string& fileName)
+{
+	_fileName = fileName;
+	_corpusBytes = 0;
+	_queueDepth = 0;
+	_lastWords = 0;
+	_lastWrite = chrono::steady_clock::now();
+}
+
+
+
+// Returns zeroed counters for one more generator thread, which stay valid as long as this RunMetrics
+ThreadMetrics* RunMetrics::addThread()
+{
+	lock_guard<mutex>	hold(_lock);
+	ThreadMetrics*		metrics = new ThreadMetrics;
+	int			section;
+
+
+	metrics->words = 0;
+	metrics->letters = 0;
+	for (section = 0; section < INDEX_SECTIONS; ++section)
+	{
+		metrics->sectionLetters[section] = 0;
+		metrics->sectionFallbacks[section] = 0;
+	}
+	_threads.emplace_back(metrics);
+
+	return metrics;
+}
+
+// Sets the bytes the corpus uses
+void RunMetrics::setCorpusBytes(const long& bytes)
+{
+	_corpusBytes = bytes;
+}
+
+// Adds delta to the number of batches waiting to be written
+void RunMetrics::changeQueueDepth(const int& delta)
+{
+	_queueDepth += delta;
+}
+
+
+
+// Writes every metric to out in Prometheus text format
+void RunMetrics::write(ostream& out)
+{
+	const char*		sectionNames[INDEX_SECTIONS] = { "first", "middle", "last" };
+	lock_guard<mutex>	hold(_lock);
+	chrono::steady_clock::time_point	now = chrono::steady_clock::now();
+	double			seconds = chrono::duration<double>(now - _lastWrite).count();
+	long long		words = 0;
+	long long		letters = 0;
+	long long		sectionLetters[INDEX_SECTIONS] = { 0 };
+	long long		sectionFallbacks[INDEX_SECTIONS] = { 0 };
+	int			section;
+	size_t			i;
+
+
+	for (i = 0; i < _threads.size(); ++i)
+	{
+		words += _threads[i]->words.load(memory_order_relaxed);
+		letters += _threads[i]->letters.load(memory_order_relaxed);
+		for (section = 0; section < INDEX_SECTIONS; ++section)
+		{
+			sectionLetters[section] += _threads[i]->sectionLetters[section].load(memory_order_relaxed);
+			sectionFallbacks[section] += _threads[i]->sectionFallbacks[section].load(memory_order_relaxed);
+		}
+	}
+
+	out << "# HELP randomword_words_total Words written." << endl;
+	out << "# TYPE randomword_words_total counter" << endl;
+	out << "randomword_words_total " << words << endl;
+
+	out << "# HELP randomword_letters_total Letters of the words written." << endl;
+	out << "# TYPE randomword_letters_total counter" << endl;
+	out << "randomword_letters_total " << letters << endl;
+
+	out << "# HELP randomword_words_per_second Words written per second since the last update." << endl;
+	out << "# TYPE randomword_words_per_second gauge" << endl;
+	out << "randomword_words_per_second " << ((seconds > 0) ? (words - _lastWords) / seconds : 0) << endl;
+
+	out << "# HELP randomword_section_letters_total Letters filled in by each third of a word." << endl;
+	out << "# TYPE randomword_section_letters_total counter" << endl;
+	for (section = 0; section < INDEX_SECTIONS; ++section)
+	{
+		out << "randomword_section_letters_total{section=\"" << sectionNames[section] << "\"} " << sectionLetters[section] << endl;
+	}
+
+	out << "# HELP randomword_section_fallbacks_total Letters of each third that no donor word supplied, so a vowel was used." << endl;
+	out << "# TYPE randomword_section_fallbacks_total counter" << endl;
+	for (section = 0; section < INDEX_SECTIONS; ++section)
+	{
+		out << "randomword_section_fallbacks_total{section=\"" << sectionNames[section] << "\"} " << sectionFallbacks[section] << endl;
+	}
+
+	out << "# HELP randomword_section_fallback_ratio Share of each third's letters that fell back to a vowel." << endl;
+	out << "# TYPE randomword_section_fallback_ratio gauge" << endl;
+	for (section = 0; section < INDEX_SECTIONS; ++section)
+	{
+		out << "randomword_section_fallback_ratio{section=\"" << sectionNames[section] << "\"} "
+			<< ((sectionLetters[section] > 0) ? (double)sectionFallbacks[section] / sectionLetters[section] : 0) << endl;
+	}
+
+	out << "# HELP randomword_queue_depth Batches generated and waiting to be written." << endl;
+	out << "# TYPE randomword_queue_depth gauge" << endl;
+	out << "randomword_queue_depth " << _queueDepth << endl;
+
+	out << "# HELP randomword_corpus_bytes Bytes the corpus uses." << endl;
+	out << "# TYPE randomword_corpus_bytes gauge" << endl;
+	out << "randomword_corpus_bytes " << _corpusBytes << endl;
+
+	out << "# HELP randomword_threads Generator threads." << endl;
+	out << "# TYPE randomword_threads gauge" << endl;
+	out << "randomword_threads " << _threads.size() << endl;
+
+	_lastWords = words;
+	_lastWrite = now;
+}
+
+// Rewrites the metrics file
+// Returns 0 for failure, 1 for success
+int RunMetrics::writeFile()
+{
+	string		partFile = _fileName + ".part";
+	ofstream	out;
+	error_code	error;
+
+
+	out.open(partFile, ios::trunc);
+	if (!out)
+	{
+		cerr << "Cannot write to " << partFile << endl;
+		return 0;
+	}
+
+	write(out);
+	out.close();
+
+	filesystem::rename(partFile, _fileName, error);
+	if ((!out) || (error))
+	{
+		cerr << "Cannot write to " << _fileName << endl;
+		return 0;
+	}
+
+	return 1;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include "utilities.h"
+#include "successorIndex.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+// RUN METRICS SETTINGS
+const int METRICS_INTERVAL_MS = 1000;	// How often runWords() rewrites the metrics file
+
+
+// The counters of one generator thread, on cache lines of their own so threads never share one
+//
+// Only the owning thread writes them, with addMetric(), so counting is a plain load, add, and
+// store with no locked instruction. Readers sum every thread's counters when they want a total.
+struct alignas(64) ThreadMetrics
+{
+	atomic<long long>	words;					// Words written
+	atomic<long long>	letters;				// Letters of those words
+	atomic<long long>	sectionLetters[INDEX_SECTIONS];		// Letters filled in by each third, before any word is thrown away
+	atomic<long long>	sectionFallbacks[INDEX_SECTIONS];	// Those letters that fell back to a vowel
+};
+
+
+// Adds amount to a counter of a ThreadMetrics owned by the calling thread
+inline void addMetric(atomic<long long>& counter, const long long& amount)
+{
+	counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+
+// Live metrics of a run, rewritten to a file in Prometheus text format while it runs
+//
+// The file is written beside itself and renamed into place, so a reader (such as the node_exporter
+// textfile collector, or just cat) never sees half of it.
+class RunMetrics
+{
+public:
+	// Constructor
+	// Writes to fileName
+	explicit RunMetrics(const string& fileName);
+	//
+	// A run's counters are handed out by pointer, so they can't be copied
+	RunMetrics(const RunMetrics&) = delete;
+	RunMetrics& operator=(const RunMetrics&) = delete;
+
+	// Returns zeroed counters for one more generator thread, which stay valid as long as this RunMetrics
+	ThreadMetrics* addThread();
+	//
+	// Sets the bytes the corpus uses
+	void setCorpusBytes(const long& bytes);
+	//
+	// Adds delta to the number of batches waiting to be written
+	void changeQueueDepth(const int& delta);
+
+	// Writes every metric to out in Prometheus text format
+	void write(ostream& out);
+	//
+	// Rewrites the metrics file
+	// Returns 0 for failure, 1 for success
+	int writeFile();
+
+private:
+	vector<unique_ptr<ThreadMetrics>>	_threads;	// Every thread's counters
+	atomic<long>		_corpusBytes;	// Bytes the corpus uses
+	atomic<int>		_queueDepth;	// Batches waiting to be written
+	string			_fileName;	// Where writeFile() writes
+	long long		_lastWords;	// Words at the last write(), for the words per second since
+	chrono::steady_clock::time_point	_lastWrite;	// Time of the last write()
+	mutex			_lock;		// Guards _threads, _lastWords, and _lastWrite
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "selfTest.h"
+#include "runMetrics.h"
+#include "wordRun.h"
+#include <filesystem>
+#include <map>
+#include <sstream>
+
+using namespace std;
+
+// RUN METRICS TEST SETTINGS
+const long long METRICS_TEST_WORDS = 5000;	// Words of each run whose metrics are checked
+
+
+
+// Reads the samples of Prometheus text in in, skipping comments, into samples by name (labels included)
+static void readSamples(istream& in, map<string, double>& samples)
+{
+	string	line;
+	size_t	split;
+
+
+	samples.clear();
+	while (getline(in, line))
+	{
+		split = line.rfind(' ');
+		if ((!line.empty()) && (line[0] != '#') && (split != string::npos))
+		{
+			samples[line.substr(0, split)] = atof(line.c_str() + split + 1);
+		}
+	}
+}
+
+// Checks that every thread's counters are summed, and the gauges written as set
+static void testCounters()
+{
+	RunMetrics		metrics(selfTestPath("unused.prom"));
+	ThreadMetrics*		first = metrics.addThread();
+	ThreadMetrics*		second = metrics.addThread();
+	stringstream		text;
+	map<string, double>	samples;
+
+
+	addMetric(first->words, 3);
+	addMetric(second->words, 4);
+	addMetric(first->letters, 30);
+	addMetric(second->letters, 12);
+	addMetric(first->sectionLetters[1], 10);
+	addMetric(second->sectionLetters[1], 10);
+	addMetric(second->sectionFallbacks[1], 5);
+	metrics.setCorpusBytes(123456);
+	metrics.changeQueueDepth(2);
+	metrics.changeQueueDepth(-1);
+
+	metrics.write(text);
+	readSamples(text, samples);
+
+	selfCheck((samples["randomword_words_total"] == 7) && (samples["randomword_letters_total"] == 42) && (samples["randomword_threads"] == 2),
+		"the counters of every thread are summed");
+	selfCheck((samples["randomword_section_letters_total{section=\"middle\"}"] == 20) && (samples["randomword_section_fallbacks_total{section=\"middle\"}"] == 5)
+		&& (samples["randomword_section_fallback_ratio{section=\"middle\"}"] == 0.25) && (samples["randomword_section_fallback_ratio{section=\"first\"}"] == 0),
+		"section letters, fallbacks, and their ratio are written per section");
+	selfCheck((samples["randomword_queue_depth"] == 1) && (samples["randomword_corpus_bytes"] == 123456), "the queue depth and corpus bytes are written as set");
+}
+
+// Checks that a run's metrics file counts every word and letter it printed, plain and batched
+static void testRunFile(const RandomWord& corpusOwner, const bool& batched)
+{
+	string			fileName = selfTestPath("run.prom");
+	RunMetrics		metrics(fileName);
+	RunSettings		settings;
+	stringstream		output;
+	ifstream		in;
+	map<string, double>	samples;
+	streambuf*		coutBuffer;
+	string			word;
+	long long		words = 0;
+	long long		letters = 0;
+	int			successValue;
+
+
+	settings.wordCount = METRICS_TEST_WORDS;
+	settings.threadCount = 2;
+	settings.batched = batched;
+	settings.metrics = &metrics;
+
+	coutBuffer = cout.rdbuf(output.rdbuf());
+	successValue = runWords(corpusOwner, nullptr, settings);
+	cout.rdbuf(coutBuffer);
+	while (getline(output, word))
+	{
+		++words;
+		letters += word.size();
+	}
+
+	in.open(fileName);
+	readSamples(in, samples);
+	in.close();
+
+	selfCheck((successValue != 0) && (samples["randomword_words_total"] == words) && (words == METRICS_TEST_WORDS) && (samples["randomword_letters_total"] == letters),
+		string("the metrics file counts every word and letter of a ") + (batched ? "batched" : "plain") + " run");
+	selfCheck((samples["randomword_section_letters_total{section=\"middle\"}"] > 0) && (samples["randomword_threads"] == 2) && (samples["randomword_queue_depth"] == 0),
+		string("the metrics file of a ") + (batched ? "batched" : "plain") + " run shows its sections, threads, and an empty queue");
+	selfCheck(!filesystem::exists(fileName + ".part"), "the metrics file is renamed into place");
+	remove(fileName.c_str());
+}
+
+
+
+// Counters, Prometheus text, and metrics files of a run
+void testRunMetrics()
+{
+	string		fileName = selfTestPath("metrics.txt");
+	RunMetrics	unwritable(selfTestPath("missing") + "/run.prom");
+	stringstream	errors;
+	streambuf*	cerrBuffer;
+
+
+	testCounters();
+
+	cerrBuffer = cerr.rdbuf(errors.rdbuf());
+	selfCheck(unwritable.writeFile() == 0, "an unwritable metrics file is reported");
+	cerr.rdbuf(cerrBuffer);
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the metrics corpus"))
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		testRunFile(aRandomWord, false);
+		testRunFile(aRandomWord, true);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
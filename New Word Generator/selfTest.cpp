@@ -0,0 +1,119 @@
+#include "selfTest.h"
+#include <filesystem>
+#include <set>
+
+using namespace std;
+
+// Checks recorded and failed by selfCheck() since runSelfTests() started
+static int	checksRun = 0;
+static int	checksFailed = 0;
+
+// Runs every module's tests, displaying each failed check and a summary
+// Returns 0 if any check failed, 1 if all passed
+int runSelfTests()
+{
+	checksRun = 0;
+	checksFailed = 0;
+
+	headerBox("Self test");
+
+	testRandomWord();
+	testSuccessorIndex();
+	testModelFile();
+	testUtilities();
+	testBlocklist();
+	testWordRun();
+	testPronounce();
+	testWordLength();
+	testLetterSampler();
+	testStartupTrace();
+	testVerify();
+	testAsyncWord();
+	testProfileRegistry();
+	testBatchGenerator();
+	testUniqueWords();
+	testRunMetrics();
+	testWordStats();
+
+	cout << checksRun << " checks, " << checksFailed << " failed" << endl;
+
+	return (checksFailed == 0) ? 1 : 0;
+}
+
+// Records one check, displaying name if it failed
+// Returns passed
+bool selfCheck(const bool& passed, const string& name)
+{
+	++checksRun;
+	if (!passed)
+	{
+		++checksFailed;
+		cout << "FAIL: " << name << endl;
+	}
+
+	return passed;
+}
+
+// Returns the path of a test file called name in the temporary directory
+string selfTestPath(const string& name)
+{
+	error_code	error;
+	string		directory = filesystem::temp_directory_path(error).string();
+
+
+	if ((error) || (directory.empty()))
+	{
+		return "./rw-selftest-" + name;
+	}
+
+	return directory + "/rw-selftest-" + name;
+}
+
+// Writes wordCount different made-up words, built from seedValue, one per line to fileName
+// Returns 0 for failure, 1 for success
+int writeTestCorpus(const string& fileName, const int& wordCount, const unsigned long long& seedValue)
+{
+	const char		consonants[] = "bcdfghjklmnprstvwz";
+	const char		vowels[] = "aeiouy";
+	unsigned long long	state = seedValue * 0x9E3779B97F4A7C15ULL + 1;
+	set<string>		words;
+	ofstream		out;
+	string			word;
+	int			length;
+	int			i;
+
+
+	out.open(fileName, ios::trunc);
+	if (!out)
+	{
+		cerr << "Cannot write to " << fileName << endl;
+		return 0;
+	}
+
+	// Alternate consonants and vowels (with the odd double letter) so the words look like words
+	while ((int)words.size() < wordCount)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		length = 3 + (int)((state >> 33) % 10);
+		word.clear();
+		for (i = 0; i < length; ++i)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			if (((state >> 60) == 0) && (i > 0))
+			{
+				word += word[i - 1];
+			}
+			else
+			{
+				word += ((i % 2) == 0) ? consonants[(state >> 33) % (sizeof(consonants) - 1)] : vowels[(state >> 33) % (sizeof(vowels) - 1)];
+			}
+		}
+		if (words.insert(word).second)
+		{
+			out << word << '\n';
+		}
+	}
+	out.close();
+
+	return (out) ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include "utilities.h"
+
+
+// SELF TEST SETTINGS
+const int SELF_TEST_WORDS = 4000;		// Made-up donor words in the corpus most tests load
+const unsigned long long SELF_TEST_SEED = 7;	// Seed of that corpus, so every run tests the same words
+
+
+// Self Test Utilities
+//
+// The checks run by --self-test. Each module's tests live beside it in <module>Test.cpp and report
+// through selfCheck(), so the suite needs nothing but the program and a writable temporary directory.
+//
+// Runs every module's tests, displaying each failed check and a summary
+// Returns 0 if any check failed, 1 if all passed
+int runSelfTests();
+//
+// Records one check, displaying name if it failed
+// Returns passed
+bool selfCheck(const bool& passed, const string& name);
+//
+// Returns the path of a test file called name in the temporary directory
+string selfTestPath(const string& name);
+//
+// Writes wordCount different made-up words, built from seedValue, one per line to fileName
+// Returns 0 for failure, 1 for success
+int writeTestCorpus(const string& fileName, const int& wordCount, const unsigned long long& seedValue);
+
+
+// Module Tests
+//
+// RandomWord generation, work budgets, and corpus updates (randomWordTest.cpp)
+void testRandomWord();
+//
+// SuccessorIndex builds and updates (successorIndexTest.cpp)
+void testSuccessorIndex();
+//
+// Model files: saving, mapping, and refusing damaged ones (modelFileTest.cpp)
+void testModelFile();
+//
+// Cstring utilities: copying, comparing, lowercasing, converting, and printing (utilitiesTest.cpp)
+void testUtilities();
+//
+// Blocklist matching, loading, and screening (blocklistTest.cpp)
+void testBlocklist();
+//
+// runWords() word counts, shortfalls, and signal handling (wordRunTest.cpp)
+void testWordRun();
+//
+// PronounceScorer scoring and WordBatch filtering (pronounceTest.cpp)
+void testPronounce();
+//
+// LengthDistribution shapes, tables, and use by RandomWord (wordLengthTest.cpp)
+void testWordLength();
+//
+// Letter tables and the samplers built on them (letterSamplerTest.cpp)
+void testLetterSampler();
+//
+// Startup phases recorded by the loader and written as Chrome trace JSON (startupTraceTest.cpp)
+void testStartupTrace();
+//
+// Distribution and throughput checks of --verify (verifyTest.cpp)
+void testVerify();
+//
+// Tasks, streams, executors, and cancellation of the C++20 async API (asyncWordTest.cpp)
+void testAsyncWord();
+//
+// Loading, sharing, and eviction of named corpora (profileRegistryTest.cpp)
+void testProfileRegistry();
+//
+// Alias table sampling and options of the batch generator (batchGeneratorTest.cpp)
+void testBatchGenerator();
+//
+// Inserting, spilling, and merging of the unique word set (uniqueWordsTest.cpp)
+void testUniqueWords();
+//
+// Counters, Prometheus text, and metrics files of a run (runMetricsTest.cpp)
+void testRunMetrics();
+//
+// HyperLogLog, count-min top words, histograms, and merging of word statistics (wordStatsTest.cpp)
+void testWordStats();
\ No newline at end of file
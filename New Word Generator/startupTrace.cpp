@@ -0,0 +1,184 @@
+#include "startupTrace.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// One phase of the trace
+struct TracePhase
+{
+	const char*	name;		// Name shown in the trace viewer
+	unsigned long long	threadId;	// Hash of the thread that ran the phase
+	double		startMicros;	// Start, in microseconds since enableTracing()
+	double		endMicros;	// End, or -1 while the phase is still running
+	long long	minorFaults;	// Page faults served without I/O (page cache hits, first touches), at the start then during
+	long long	majorFaults;	// Page faults that waited on I/O, at the start then during
+	long long	bytes;		// Bytes the phase handled
+	long long	lines;		// Lines the phase handled
+};
+
+static atomic<bool>		traceOn(false);		// Set by enableTracing()
+static chrono::steady_clock::time_point	traceStart;	// When enableTracing() was called
+static vector<TracePhase>	tracePhases;		// Every phase begun so far
+static mutex			traceLock;		// Guards tracePhases
+
+
+
+// Returns microseconds since enableTracing() on the monotonic clock
+static double traceMicros()
+{
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - traceStart).count();
+}
+
+// Sets minorFaults and majorFaults to the page faults the process has taken so far
+static void countPageFaults(long long& minorFaults, long long& majorFaults)
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS	counters;
+
+	// Windows only counts faults of both kinds together
+	minorFaults = 0;
+	majorFaults = 0;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		minorFaults = counters.PageFaultCount;
+	}
+#else
+	struct rusage	usage;
+
+	minorFaults = 0;
+	majorFaults = 0;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		minorFaults = usage.ru_minflt;
+		majorFaults = usage.ru_majflt;
+	}
+#endif
+}
+
+
+
+// Starts recording phases, with timestamps measured from this call
+void enableTracing()
+{
+	lock_guard<mutex>	hold(traceLock);
+
+	tracePhases.clear();
+	traceStart = chrono::steady_clock::now();
+	traceOn = true;
+}
+
+// Starts timing a phase called name (name must outlive the trace, a string literal is best)
+// Returns the phase to pass to endTracePhase(), or TRACE_NO_PHASE while tracing is off
+int beginTracePhase(const char name[])
+{
+	TracePhase	phase;
+
+
+	if (!traceOn)
+	{
+		return TRACE_NO_PHASE;
+	}
+
+	phase.name = name;
+	phase.threadId = hash<thread::id>()(this_thread::get_id());
+	phase.endMicros = -1;
+	phase.bytes = 0;
+	phase.lines = 0;
+	countPageFaults(phase.minorFaults, phase.majorFaults);
+	phase.startMicros = traceMicros();
+
+	lock_guard<mutex>	hold(traceLock);
+	tracePhases.push_back(phase);
+
+	return (int)tracePhases.size() - 1;
+}
+
+// Finishes a phase begun by beginTracePhase(), recording the bytes and lines it handled (0 if not meaningful)
+void endTracePhase(const int& phase, const long long& bytes, const long long& lines)
+{
+	double		endMicros;
+	long long	minorFaults;
+	long long	majorFaults;
+
+
+	if (phase == TRACE_NO_PHASE)
+	{
+		return;
+	}
+
+	endMicros = traceMicros();
+	countPageFaults(minorFaults, majorFaults);
+
+	lock_guard<mutex>	hold(traceLock);
+	if ((phase >= 0) && (phase < (int)tracePhases.size()))
+	{
+		tracePhases[phase].endMicros = endMicros;
+		tracePhases[phase].minorFaults = minorFaults - tracePhases[phase].minorFaults;
+		tracePhases[phase].majorFaults = majorFaults - tracePhases[phase].majorFaults;
+		tracePhases[phase].bytes = bytes;
+		tracePhases[phase].lines = lines;
+	}
+}
+
+// Writes every finished phase to fileName as Chrome trace JSON
+// Returns 0 for failure, 1 for success
+int writeTrace(const string& fileName)
+{
+	ofstream	out;
+	bool		first = true;
+	long long	processId;
+	size_t		i;
+
+
+#ifdef _WIN32
+	processId = GetCurrentProcessId();
+#else
+	processId = getpid();
+#endif
+
+	out.open(fileName, ios::trunc);
+	if (!out)
+	{
+		cerr << "Cannot write to " << fileName << endl;
+		return 0;
+	}
+
+	lock_guard<mutex>	hold(traceLock);
+
+	// Complete ("X") events; the viewer nests the ones that fall inside another on the same thread
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (i = 0; i < tracePhases.size(); ++i)
+	{
+		if (tracePhases[i].endMicros < 0)
+		{
+			continue;
+		}
+
+		out << (first ? "\n" : ",\n");
+		out << "{\"name\":\"" << tracePhases[i].name << "\",\"cat\":\"startup\",\"ph\":\"X\"";
+		out << ",\"pid\":" << processId << ",\"tid\":" << (tracePhases[i].threadId & 0xFFFFFF);
+		out << fixed;
+		out.precision(3);
+		out << ",\"ts\":" << tracePhases[i].startMicros << ",\"dur\":" << (tracePhases[i].endMicros - tracePhases[i].startMicros);
+		out << ",\"args\":{\"bytes\":" << tracePhases[i].bytes << ",\"lines\":" << tracePhases[i].lines;
+		out << ",\"minorFaults\":" << tracePhases[i].minorFaults << ",\"majorFaults\":" << tracePhases[i].majorFaults << "}}";
+		first = false;
+	}
+	out << "\n]}\n";
+	out.close();
+
+	return (out) ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+#include "utilities.h"
+
+
+// STARTUP TRACE SETTINGS
+const int TRACE_NO_PHASE = -1;		// Returned by beginTracePhase() while tracing is off
+
+
+// Startup Trace Utilities
+//
+// Records how long each phase of startup takes, with the bytes and lines it handled and the page
+// faults taken while it ran, and writes them as a Chrome trace (chrome://tracing or ui.perfetto.dev).
+// Tracing is off until enableTracing() is called, and then every call below is safe from any thread.
+//
+// Starts recording phases, with timestamps measured from this call
+void enableTracing();
+//
+// Starts timing a phase called name (name must outlive the trace, a string literal is best)
+// Phases begun inside another phase on the same thread show nested under it
+// Returns the phase to pass to endTracePhase(), or TRACE_NO_PHASE while tracing is off
+int beginTracePhase(const char name[]);
+//
+// Finishes a phase begun by beginTracePhase(), recording the bytes and lines it handled (0 if not meaningful)
+void endTracePhase(const int& phase, const long long& bytes, const long long& lines);
+//
+// Writes every finished phase to fileName as Chrome trace JSON
+// Returns 0 for failure, 1 for success
+int writeTrace(const string& fileName);
\ No newline at end of file
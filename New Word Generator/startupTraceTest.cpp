@@ -0,0 +1,60 @@
+#include "selfTest.h"
+#include "randomWord.h"
+#include "startupTrace.h"
+#include <sstream>
+
+using namespace std;
+
+// Returns the whole of fileName, or an empty string if it can't be read
+static string readTrace(const string& fileName)
+{
+	ifstream	in(fileName);
+	stringstream	contents;
+
+
+	contents << in.rdbuf();
+
+	return contents.str();
+}
+
+
+
+// Startup phases recorded by the loader and written as Chrome trace JSON
+void testStartupTrace()
+{
+	string	corpusName = selfTestPath("trace-corpus.txt");
+	string	traceName = selfTestPath("trace.json");
+	string	trace;
+	int	running;
+	int	phase;
+
+
+	selfCheck(beginTracePhase("before") == TRACE_NO_PHASE, "no phase is recorded before tracing is enabled");
+	if (!selfCheck(writeTestCorpus(corpusName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the trace corpus"))
+	{
+		return;
+	}
+
+	enableTracing();
+	running = beginTracePhase("still running");
+	phase = beginTracePhase("self test");
+	endTracePhase(phase, 123, 45);
+	{
+		RandomWord	aRandomWord(corpusName, 0);
+	}
+	selfCheck(writeTrace(traceName) != 0, "the trace is written");
+	endTracePhase(running, 0, 0);
+	trace = readTrace(traceName);
+
+	selfCheck((trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0) && (trace.rfind("\n]}\n") == trace.size() - 4),
+		"the trace is one JSON object holding the event list");
+	selfCheck(trace.find("\"name\":\"self test\",\"cat\":\"startup\",\"ph\":\"X\"") != string::npos, "a finished phase is written as a complete event");
+	selfCheck(trace.find("\"args\":{\"bytes\":123,\"lines\":45,") != string::npos, "a phase records the bytes and lines it was given");
+	selfCheck((trace.find("\"construct RandomWord\"") != string::npos) && (trace.find("\"copy pass\"") != string::npos)
+		&& (trace.find("\"lines\":" + to_string(SELF_TEST_WORDS) + ",") != string::npos), "the loader traces its passes with the words they read");
+	selfCheck(trace.find("still running") == string::npos, "a phase that hasn't finished is left out");
+	selfCheck(writeTrace(selfTestPath("missing") + "/trace.json") == 0, "an unwritable trace file is reported");
+
+	remove(corpusName.c_str());
+	remove(traceName.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "successorIndex.h"
+
+using namespace std;
+
+SuccessorIndex::SuccessorIndex()
+{
+	memset(_counts, 0, sizeof(_counts));
+	memset(_totals, 0, sizeof(_totals));
+}
+
+
+
+// Counts the listSize words starting at arena + offsets[0] .. arena + offsets[listSize - 1], splitting the
+// words across threadCount threads (0 uses one thread per core). The counts are the same for any number of threads.
+// Returns 0 for failure, 1 for success
+int SuccessorIndex::build(const char arena[], const int offsets[], const int& listSize, const int& threadCount)
+{
+	const int		cellCount = INDEX_SECTIONS * INDEX_LETTERS * INDEX_SUCCESSORS;
+	int			threads = threadCount;		// Number of threads actually used
+	vector<ThreadCounts>	tables;				// One private count table per thread
+	vector<thread>		workers;
+	int			i;
+
+
+	if (threads <= 0)
+	{
+		threads = max(1, (int)thread::hardware_concurrency());
+	}
+	// Don't start threads that would have too few words to pay for themselves
+	threads = max(1, min(threads, listSize / INDEX_WORDS_PER_THREAD));
+
+	tables.resize(threads);
+
+	// Each thread counts its own slice of the corpus into its own table
+	for (i = 0; i < threads; ++i)
+	{
+		memset(tables[i].counts, 0, sizeof(tables[i].counts));
+		workers.push_back(thread(&SuccessorIndex::countWords, arena, offsets,
+			(int)((long)listSize * i / threads), (int)((long)listSize * (i + 1) / threads), &tables[i]));
+	}
+	for (i = 0; i < threads; ++i)
+	{
+		workers[i].join();
+	}
+	workers.clear();
+
+	// Then each thread sums its own slice of the cells across every table
+	for (i = 0; i < threads; ++i)
+	{
+		workers.push_back(thread(&SuccessorIndex::mergeCells, this, cref(tables),
+			cellCount * i / threads, cellCount * (i + 1) / threads));
+	}
+	for (i = 0; i < threads; ++i)
+	{
+		workers[i].join();
+	}
+
+	sumTotals();
+
+	return 1;
+}
+
+// Adds (delta of 1) or takes away (delta of -1) the counts from a single word
+void SuccessorIndex::updateWord(const char word[], const int& delta)
+{
+	countWord(word, delta, _counts);
+	sumTotals();
+}
+
+
+
+// Returns the number of donor words that can supply a letter after letter in section
+int SuccessorIndex::total(const int& section, const char& letter) const
+{
+	int	row = letterIndex(letter);
+
+	return (row != LETTER_NONE) ? _totals[section][row] : 0;
+}
+
+// Returns the number of donor words that supply successorSlot after letter in section
+int SuccessorIndex::count(const int& section, const char& letter, const int& successorSlot) const
+{
+	int	row = letterIndex(letter);
+
+	return (row != LETTER_NONE) ? _counts[section][row][successorSlot] : 0;
+}
+
+// Check if two indexes hold the same counts
+// Returns true if every count matches
+bool SuccessorIndex::matches(const SuccessorIndex& other) const
+{
+	return (!memcmp(_counts, other._counts, sizeof(_counts)));
+}
+
+// Check if the counts could have come from build(), as they must before an index read from a file is used
+// Returns true if no count is below 0 and every total is the sum of its row
+bool SuccessorIndex::valid() const
+{
+	long long	rowTotal;
+	int		section;
+	int		letter;
+	int		slot;
+
+
+	for (section = 0; section < INDEX_SECTIONS; ++section)
+	{
+		for (letter = 0; letter < INDEX_LETTERS; ++letter)
+		{
+			rowTotal = 0;
+			for (slot = 0; slot < INDEX_SUCCESSORS; ++slot)
+			{
+				if (_counts[section][letter][slot] < 0)
+				{
+					return false;
+				}
+				rowTotal += _counts[section][letter][slot];
+			}
+			if (rowTotal != _totals[section][letter])
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+
+// Adds delta to counts for every (section, letter) row word contributes to
+void SuccessorIndex::countWord(const char word[], const int& delta, int counts[INDEX_SECTIONS][INDEX_LETTERS][INDEX_SUCCESSORS])
+{
+	int	wordLength = strlen(word);
+	int	donorLower;
+	int	donorUpper;
+	int	section;
+	int	letter;
+	int	slot;
+	bool	found[INDEX_LETTERS];	// Letters that already gave this section a successor
+	int	i;
+
+
+	for (section = 0; section < INDEX_SECTIONS; ++section)
+	{
+		donorBounds(section, wordLength, donorLower, donorUpper);
+		memset(found, 0, sizeof(found));
+
+		for (i = donorLower; i < donorUpper; ++i)
+		{
+			letter = letterIndex(word[i]);
+			if ((letter != LETTER_NONE) && (!found[letter]))
+			{
+				// fillSection() keeps scanning past a letter followed by a non-alpha
+				slot = successorSlot(word[i + 1]);
+				if (slot != -1)
+				{
+					counts[section][letter][slot] += delta;
+					found[letter] = true;
+				}
+			}
+		}
+	}
+}
+
+// Counts the words at offsets[firstWord] .. offsets[lastWord - 1] into a zeroed table
+void SuccessorIndex::countWords(const char arena[], const int offsets[], const int& firstWord, const int& lastWord, ThreadCounts* table)
+{
+	int	i;
+
+	for (i = firstWord; i < lastWord; ++i)
+	{
+		countWord(arena + offsets[i], 1, table->counts);
+	}
+}
+
+// Sums cell firstCell .. lastCell - 1 of every table into _counts
+void SuccessorIndex::mergeCells(const vector<ThreadCounts>& tables, const int& firstCell, const int& lastCell)
+{
+	int*		cells = &_counts[0][0][0];
+	const int*	tableCells;
+	size_t		t;
+	int		i;
+
+
+	for (i = firstCell; i < lastCell; ++i)
+	{
+		cells[i] = 0;
+	}
+	for (t = 0; t < tables.size(); ++t)
+	{
+		tableCells = &tables[t].counts[0][0][0];
+		for (i = firstCell; i < lastCell; ++i)
+		{
+			cells[i] += tableCells[i];
+		}
+	}
+}
+
+// Recomputes _totals from _counts
+void SuccessorIndex::sumTotals()
+{
+	int	section;
+	int	letter;
+	int	i;
+
+
+	for (section = 0; section < INDEX_SECTIONS; ++section)
+	{
+		for (letter = 0; letter < INDEX_LETTERS; ++letter)
+		{
+			_totals[section][letter] = 0;
+			for (i = 0; i < INDEX_SUCCESSORS; ++i)
+			{
+				_totals[section][letter] += _counts[section][letter][i];
+			}
+		}
+	}
+}
+
+// Gives index bounds for one third of a donor word, the same as RandomWord::firstDonor(), middleDonor(), and lastDonor()
+void SuccessorIndex::donorBounds(const int& section, const int& donorWordLength, int& donorLower, int& donorUpper)
+{
+	int	donorThird = donorWordLength / 3;
+
+	if (section == 0)
+	{
+		donorLower = 0;
+		donorUpper = donorThird;
+	}
+	else if (section == 1)
+	{
+		donorLower = donorThird;
+		donorUpper = donorWordLength - donorThird;
+	}
+	else
+	{
+		donorLower = donorWordLength - donorThird;
+		donorUpper = donorWordLength;
+	}
+}
+
+// Returns the column of a successor letter, or -1 if it is not an alpha
+int SuccessorIndex::successorSlot(const char& successor)
+{
+	if ((successor >= 'a') && (successor <= 'z'))
+	{
+		return successor - 'a';
+	}
+	if ((successor >= 'A') && (successor <= 'Z'))
+	{
+		return INDEX_LETTERS + (successor - 'A');
+	}
+
+	return -1;
+}
\ No newline at end of file
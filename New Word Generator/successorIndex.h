@@ -0,0 +1,83 @@
+#pragma once
+#include "utilities.h"
+#include "letterSampler.h"
+#include <thread>
+#include <vector>
+
+
+// SUCCESSOR INDEX SETTINGS
+// Shape of the count tables
+const int INDEX_SECTIONS = 3;		// First, middle, and last third of a donor word
+const int INDEX_LETTERS = LETTER_COUNT;	// Letters a successor can follow, without regard to case
+const int INDEX_SUCCESSORS = 52;	// Successor letters, 'a'-'z' then 'A'-'Z' (donor case is kept)
+const int INDEX_WORDS_PER_THREAD = 16384;	// Fewest donor words worth handing to one more build thread
+
+
+// Counts, for each third of the donor words, which letter follows each letter
+//
+// A donor word contributes at most once to each (section, letter) row: the successor
+// taken from the first place in that third where the letter is followed by an alpha.
+// That is exactly the letter RandomWord::fillSection() would pull from the word, so
+// count(section, letter, successor) / total(section, letter) is the chance that a
+// random donor supplies that successor.
+class SuccessorIndex
+{
+public:
+	// Constructor
+	// Starts with every count at 0
+	SuccessorIndex();
+
+	// Counts the listSize words starting at arena + offsets[0] .. arena + offsets[listSize - 1], splitting the
+	// words across threadCount threads (0 uses one thread per core). The counts are the same for any number of threads.
+	// Returns 0 for failure, 1 for success
+	int build(const char arena[], const int offsets[], const int& listSize, const int& threadCount);
+	//
+	// Adds (delta of 1) or takes away (delta of -1) the counts from a single word
+	void updateWord(const char word[], const int& delta);
+
+	// Returns the number of donor words that can supply a letter after letter in section
+	int total(const int& section, const char& letter) const;
+	//
+	// Returns the number of donor words that supply successorSlot after letter in section
+	int count(const int& section, const char& letter, const int& successorSlot) const;
+	//
+	// Check if two indexes hold the same counts
+	// Returns true if every count matches
+	bool matches(const SuccessorIndex& other) const;
+	//
+	// Check if the counts could have come from build(), as they must before an index read from a file is used
+	// Returns true if no count is below 0 and every total is the sum of its row
+	bool valid() const;
+
+private:
+	// The counts for one build thread, padded to whole cache lines so threads never share a line
+	struct alignas(64) ThreadCounts
+	{
+		int	counts[INDEX_SECTIONS][INDEX_LETTERS][INDEX_SUCCESSORS];
+	};
+
+	int	_counts[INDEX_SECTIONS][INDEX_LETTERS][INDEX_SUCCESSORS];	// Donor words supplying each successor
+	int	_totals[INDEX_SECTIONS][INDEX_LETTERS];			// Sum of each _counts row
+
+
+
+	// BUILD SUPPORT
+	//
+	// Adds delta to counts for every (section, letter) row word contributes to
+	static void countWord(const char word[], const int& delta, int counts[INDEX_SECTIONS][INDEX_LETTERS][INDEX_SUCCESSORS]);
+	//
+	// Counts the words at offsets[firstWord] .. offsets[lastWord - 1] into a zeroed table
+	static void countWords(const char arena[], const int offsets[], const int& firstWord, const int& lastWord, ThreadCounts* table);
+	//
+	// Sums cell firstCell .. lastCell - 1 of every table into _counts
+	void mergeCells(const vector<ThreadCounts>& tables, const int& firstCell, const int& lastCell);
+	//
+	// Recomputes _totals from _counts
+	void sumTotals();
+	//
+	// Gives index bounds for one third of a donor word, the same as RandomWord::firstDonor(), middleDonor(), and lastDonor()
+	static void donorBounds(const int& section, const int& donorWordLength, int& donorLower, int& donorUpper);
+	//
+	// Returns the column of a successor letter, or -1 if it is not an alpha
+	static int successorSlot(const char& successor);
+};
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "selfTest.h"
+#include "randomWord.h"
+#include <vector>
+
+using namespace std;
+
+// Copies the donor words of aRandomWord into arena and offsets, laid out the way SuccessorIndex::build() reads them
+static void copyDonorList(const RandomWord& aRandomWord, vector<char>& arena, vector<int>& offsets)
+{
+	const char*	word;
+	int		i;
+
+
+	arena.clear();
+	offsets.clear();
+	for (i = 0; i < aRandomWord.listSize(); ++i)
+	{
+		word = aRandomWord.donorWord(i);
+		arena.push_back((char)strlen(word));
+		offsets.push_back((int)arena.size());
+		arena.insert(arena.end(), word, word + strlen(word) + 1);
+	}
+}
+
+// Checks that the counts are the same however many threads build them
+static void testParallelBuild(const RandomWord& aRandomWord)
+{
+	vector<char>	arena;
+	vector<int>	offsets;
+	SuccessorIndex	single;
+	SuccessorIndex	parallel;
+	bool		identical = true;
+	int		threadCount;
+
+
+	copyDonorList(aRandomWord, arena, offsets);
+	single.build(arena.data(), offsets.data(), (int)offsets.size(), 1);
+
+	// The corpus holds enough words for every one of these thread counts to be used in full
+	for (threadCount = 2; threadCount <= 6; ++threadCount)
+	{
+		parallel.build(arena.data(), offsets.data(), (int)offsets.size(), threadCount);
+		identical &= parallel.matches(single);
+	}
+
+	selfCheck(identical, "a build on 2 to 6 threads matches a build on 1 thread");
+	selfCheck(aRandomWord.successorIndex().matches(single), "the loader's build matches a build on 1 thread");
+}
+
+// Checks that the counts updated word by word match counts built again from the whole donor list
+static void testIncrementalUpdates(RandomWord& aRandomWord)
+{
+	vector<char>	arena;
+	vector<int>	offsets;
+	SuccessorIndex	rebuilt;
+	string		word;
+	int		i;
+
+
+	for (i = 0; i < 500; ++i)
+	{
+		word = aRandomWord.donorWord(i);
+		aRandomWord.removeDonorWord(word.c_str());
+		word[0] = 'q';
+		aRandomWord.addDonorWord(word.c_str());
+	}
+
+	copyDonorList(aRandomWord, arena, offsets);
+	rebuilt.build(arena.data(), offsets.data(), (int)offsets.size(), 1);
+
+	selfCheck(aRandomWord.successorIndex().matches(rebuilt), "counts updated by addDonorWord() and removeDonorWord() match a rebuild");
+	selfCheck(!aRandomWord.successorIndex().matches(SuccessorIndex()), "matches() tells different counts apart");
+}
+
+
+
+// SuccessorIndex builds and updates
+void testSuccessorIndex()
+{
+	string	fileName = selfTestPath("index.txt");
+
+
+	if (selfCheck(writeTestCorpus(fileName, 6 * INDEX_WORDS_PER_THREAD, SELF_TEST_SEED) != 0, "write the successor index corpus"))
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		testParallelBuild(aRandomWord);
+		testIncrementalUpdates(aRandomWord);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,596 @@
+#include "uniqueWords.h"
+#include "modelFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+using namespace std;
+
+UniqueWordSet::UniqueWordSet(const long& memoryCap, const string& spillDirectory)
+{
+	long		cap = (memoryCap > 0) ? max(memoryCap, UNIQUE_SMALLEST_CAP) : UNIQUE_DEFAULT_CAP;
+	long long	slotCount = 1;
+	error_code	error;
+	long long	i;
+
+
+	// Half the cap for the table, in a power of 2 of slots
+	while (slotCount * 2 * (long long)sizeof(atomic<unsigned long long>) <= cap / 2)
+	{
+		slotCount *= 2;
+	}
+
+	_slots = new atomic<unsigned long long>[slotCount];
+	for (i = 0; i < slotCount; ++i)
+	{
+		_slots[i].store(0, memory_order_relaxed);
+	}
+	_slotMask = slotCount - 1;
+	_maxUsed = slotCount / 2;
+	_used = 0;
+
+	// A quarter for the arena, which an offset must be able to reach
+	_arenaBytes = min((long long)cap / 4, (1LL << UNIQUE_OFFSET_BITS) - 1);
+	_arena = new char[_arenaBytes];
+	_arenaUsed = 0;
+
+	_active = 0;
+	_spilling = false;
+	_failed = false;
+	_words = 0;
+	_duplicates = 0;
+
+	_spillDirectory = spillDirectory;
+	if (_spillDirectory.empty())
+	{
+		_spillDirectory = filesystem::temp_directory_path(error).string();
+		if ((error) || (_spillDirectory.empty()))
+		{
+			_spillDirectory = ".";
+		}
+	}
+	_runStamp = chrono::steady_clock::now().time_since_epoch().count() ^ (long long)this;
+	_runFiles = 0;
+}
+
+UniqueWordSet::~UniqueWordSet()
+{
+	size_t	i;
+
+
+	for (i = 0; i < _runs.size(); ++i)
+	{
+		dropRun(_runs[i]);
+	}
+
+	delete[] _slots;
+	delete[] _arena;
+}
+
+
+
+// Adds word to the set, spilling first if the table is full
+// Returns 1 if word is new, 0 if it was already in the set, or -1 if a run could not be written
+int UniqueWordSet::insert(const char word[])
+{
+	int			length;
+	unsigned long long	packed = packWord(word, length);
+	unsigned long long	hash = (packed != 0) ? hashPacked(packed) : hashLongWord(word);
+	int			result;
+
+
+	for (;;)
+	{
+		if (_failed)
+		{
+			return -1;
+		}
+
+		enterTable();
+		result = ((!_runs.empty()) && (inRuns(word, packed))) ? 0 : tryInsert(word, packed, hash, length);
+		leaveTable();
+
+		if (result == 0)
+		{
+			++_duplicates;
+			return 0;
+		}
+
+		// Full tables are spilled by whichever thread notices, and a word that found no room tries again after
+		if ((result < 0) || (_used >= _maxUsed))
+		{
+			if (spill() == 0)
+			{
+				return -1;
+			}
+		}
+
+		if (result > 0)
+		{
+			++_words;
+			return 1;
+		}
+	}
+}
+
+
+
+// Returns the number of words inserted
+long long UniqueWordSet::wordCount() const
+{
+	return _words;
+}
+
+// Returns the number of inserts turned away as duplicates
+long long UniqueWordSet::duplicateCount() const
+{
+	return _duplicates;
+}
+
+// Returns the number of runs on disk (merged runs count once)
+int UniqueWordSet::runCount() const
+{
+	return (int)_runs.size();
+}
+
+// Displays the counts above to out
+void UniqueWordSet::display(ostream& out) const
+{
+	out << "Unique words:      " << wordCount() << endl;
+	out << "Duplicates redone: " << duplicateCount() << endl;
+	out << "Runs on disk:      " << runCount() << " (in " << _spillDirectory << ")" << endl;
+}
+
+
+
+// Waits for any spill to finish and enters the table
+void UniqueWordSet::enterTable()
+{
+	for (;;)
+	{
+		while (_spilling)
+		{
+			this_thread::yield();
+		}
+
+		// Announce first and check again, so a spill that started in between is never missed
+		++_active;
+		if (!_spilling)
+		{
+			return;
+		}
+		--_active;
+	}
+}
+
+// Leaves the table
+void UniqueWordSet::leaveTable()
+{
+	--_active;
+}
+
+// Looks word up and claims a slot for it if it is new, with the table entered
+// Returns 1 if word is new, 0 if it was already in the set, or -1 if the arena is full
+int UniqueWordSet::tryInsert(const char word[], const unsigned long long& packed, const unsigned long long& hash, const int& length)
+{
+	const unsigned long long	offsetMask = (1ULL << UNIQUE_OFFSET_BITS) - 1;
+	const unsigned long long	tag = UNIQUE_LONG_KEY | (hash & ~offsetMask);	// The bits every long key for word starts with
+	unsigned long long		key = packed;	// What goes in the slot (long words get theirs once they have an offset)
+	unsigned long long		current;
+	long long			offset;
+	long long			slot = hash & _slotMask;
+
+
+	for (;; slot = (slot + 1) & _slotMask)
+	{
+		current = _slots[slot].load(memory_order_acquire);
+
+		if (current == 0)
+		{
+			// Copy a long word into the arena before publishing its slot
+			if (key == 0)
+			{
+				offset = _arenaUsed.fetch_add(length + 1);
+				if (offset + length + 1 > _arenaBytes)
+				{
+					return -1;
+				}
+				memcpy(_arena + offset, word, length + 1);
+				key = tag | offset;
+			}
+
+			if (_slots[slot].compare_exchange_strong(current, key, memory_order_acq_rel, memory_order_acquire))
+			{
+				++_used;
+				return 1;
+			}
+			// Another thread claimed the slot first, so check what it put there
+		}
+
+		if (packed != 0)
+		{
+			if (current == packed)
+			{
+				return 0;
+			}
+		}
+		else if (((current & ~offsetMask) == tag) && (!strcmp(_arena + (current & offsetMask), word)))
+		{
+			return 0;
+		}
+	}
+}
+
+// Check if a spilled run holds word (packed as packed, or 0 if it is too long to pack)
+// Returns true if any run holds it
+bool UniqueWordSet::inRuns(const char word[], const unsigned long long& packed) const
+{
+	const char*	runWord;
+	const char*	runEnd;
+	int		difference;
+	size_t		fence;
+	size_t		r;
+	int		i;
+
+
+	for (r = 0; r < _runs.size(); ++r)
+	{
+		const SpilledRun&	run = _runs[r];
+
+		if (packed != 0)
+		{
+			if (binary_search(run.packed, run.packed + run.packedCount, packed))
+			{
+				return true;
+			}
+			continue;
+		}
+
+		// Find the last fence not after word, then walk the words up to the next fence
+		fence = upper_bound(run.fences.begin(), run.fences.end(), word,
+			[&run](const char* target, const long long& offset) { return strcmp(target, run.longWords + offset) < 0; }) - run.fences.begin();
+		if (fence == 0)
+		{
+			continue;
+		}
+
+		runWord = run.longWords + run.fences[fence - 1];
+		runEnd = run.longWords + run.longBytes;
+		for (i = 0; (i < UNIQUE_FENCE_WORDS) && (runWord < runEnd); ++i)
+		{
+			difference = strcmp(runWord, word);
+			if (difference == 0)
+			{
+				return true;
+			}
+			if (difference > 0)
+			{
+				break;
+			}
+			runWord += strlen(runWord) + 1;
+		}
+	}
+
+	return false;
+}
+
+
+
+// Holds every other thread out of the table and writes it to a new run if it is still full
+// Returns 0 if the run could not be written, 1 for success
+int UniqueWordSet::spill()
+{
+	bool		expected = false;
+	SpilledRun	run;
+	SpilledRun	merged;
+	size_t		last;
+	long long	i;
+
+
+	// Only one thread spills; the others wait for it and try again
+	if (!_spilling.compare_exchange_strong(expected, true))
+	{
+		while (_spilling)
+		{
+			this_thread::yield();
+		}
+		return (_failed) ? 0 : 1;
+	}
+
+	while (_active != 0)
+	{
+		this_thread::yield();
+	}
+
+	// Another thread may have spilled since this one found the table full
+	if ((_used >= _maxUsed) || (_arenaUsed > _arenaBytes))
+	{
+		if (writeRun(run) == 0)
+		{
+			_failed = true;
+		}
+		else
+		{
+			_runs.push_back(move(run));
+
+			for (i = 0; i <= _slotMask; ++i)
+			{
+				_slots[i].store(0, memory_order_relaxed);
+			}
+			_used = 0;
+			_arenaUsed = 0;
+		}
+
+		// Merge the newest runs while they are close in size, so there are never many to search
+		while ((!_failed) && (_runs.size() >= 2))
+		{
+			last = _runs.size() - 1;
+			if (_runs[last - 1].fileBytes > 2 * _runs[last].fileBytes)
+			{
+				break;
+			}
+
+			if (mergeRuns(_runs[last - 1], _runs[last], merged) == 0)
+			{
+				_failed = true;
+				break;
+			}
+			dropRun(_runs[last]);
+			dropRun(_runs[last - 1]);
+			_runs.pop_back();
+			_runs[last - 1] = move(merged);
+			merged = SpilledRun();
+		}
+	}
+
+	_spilling = false;
+
+	return (_failed) ? 0 : 1;
+}
+
+// Sorts the table's words into a new run file and maps it into run
+// Returns 0 for failure, 1 for success
+int UniqueWordSet::writeRun(SpilledRun& run)
+{
+	const unsigned long long	offsetMask = (1ULL << UNIQUE_OFFSET_BITS) - 1;
+	vector<unsigned long long>	packed;
+	vector<const char*>		longWords;
+	ofstream			out;
+	unsigned long long		key;
+	size_t				i;
+
+
+	for (i = 0; i <= (size_t)_slotMask; ++i)
+	{
+		key = _slots[i].load(memory_order_relaxed);
+		if ((key & UNIQUE_LONG_KEY) != 0)
+		{
+			longWords.push_back(_arena + (key & offsetMask));
+		}
+		else if (key != 0)
+		{
+			packed.push_back(key);
+		}
+	}
+
+	sort(packed.begin(), packed.end());
+	sort(longWords.begin(), longWords.end(), [](const char* left, const char* right) { return strcmp(left, right) < 0; });
+
+	if (startRun(out, run) == 0)
+	{
+		return 0;
+	}
+
+	out.write((const char*)packed.data(), packed.size() * sizeof(unsigned long long));
+	run.packedCount = packed.size();
+	for (i = 0; i < longWords.size(); ++i)
+	{
+		addLongWord(out, longWords[i], run);
+	}
+
+	return finishRun(out, run);
+}
+
+// Merges older and newer into a new run file and maps it into merged
+// Returns 0 for failure, 1 for success
+int UniqueWordSet::mergeRuns(const SpilledRun& older, const SpilledRun& newer, SpilledRun& merged)
+{
+	ofstream	out;
+	const char*	olderWord = older.longWords;
+	const char*	newerWord = newer.longWords;
+	const char*	olderEnd = older.longWords + older.longBytes;
+	const char*	newerEnd = newer.longWords + newer.longBytes;
+	long long	o = 0;
+	long long	n = 0;
+
+
+	if (startRun(out, merged) == 0)
+	{
+		return 0;
+	}
+
+	// A word is never in two runs, so neither list has anything the other one has
+	while ((o < older.packedCount) || (n < newer.packedCount))
+	{
+		if ((n >= newer.packedCount) || ((o < older.packedCount) && (older.packed[o] < newer.packed[n])))
+		{
+			out.write((const char*)&older.packed[o++], sizeof(unsigned long long));
+		}
+		else
+		{
+			out.write((const char*)&newer.packed[n++], sizeof(unsigned long long));
+		}
+	}
+	merged.packedCount = older.packedCount + newer.packedCount;
+
+	while ((olderWord < olderEnd) || (newerWord < newerEnd))
+	{
+		if ((newerWord >= newerEnd) || ((olderWord < olderEnd) && (strcmp(olderWord, newerWord) < 0)))
+		{
+			addLongWord(out, olderWord, merged);
+			olderWord += strlen(olderWord) + 1;
+		}
+		else
+		{
+			addLongWord(out, newerWord, merged);
+			newerWord += strlen(newerWord) + 1;
+		}
+	}
+
+	return finishRun(out, merged);
+}
+
+// Opens a new run file for run, leaving room for its header
+// Returns 0 for failure, 1 for success
+int UniqueWordSet::startRun(ofstream& out, SpilledRun& run)
+{
+	RunHeader	header;
+
+
+	run.fileName = _spillDirectory + "/unique-" + to_string(_runStamp) + "-" + to_string(_runFiles++) + ".run";
+	run.mapping = nullptr;
+	run.fileBytes = 0;
+	run.packedCount = 0;
+	run.longCount = 0;
+	run.longBytes = 0;
+	run.fences.clear();
+
+	out.open(run.fileName, ios::binary | ios::trunc);
+	if (!out)
+	{
+		cerr << "Cannot write to " << run.fileName << endl;
+		return 0;
+	}
+
+	// finishRun() writes the header again once the counts are known
+	memset(&header, 0, sizeof(header));
+	out.write((const char*)&header, sizeof(header));
+
+	return 1;
+}
+
+// Appends a long word to a run being written, adding a fence every UNIQUE_FENCE_WORDS words
+void UniqueWordSet::addLongWord(ofstream& out, const char word[], SpilledRun& run)
+{
+	long long	bytes = strlen(word) + 1;
+
+
+	if (run.longCount % UNIQUE_FENCE_WORDS == 0)
+	{
+		run.fences.push_back(run.longBytes);
+	}
+
+	out.write(word, bytes);
+	run.longBytes += bytes;
+	++run.longCount;
+}
+
+// Writes the header of a run being written, closes it, and maps it into run
+// Returns 0 for failure, 1 for success
+int UniqueWordSet::finishRun(ofstream& out, SpilledRun& run)
+{
+	RunHeader	header;
+
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, UNIQUE_RUN_MAGIC, sizeof(UNIQUE_RUN_MAGIC));
+	header.packedCount = run.packedCount;
+	header.longCount = run.longCount;
+	header.longBytes = run.longBytes;
+
+	out.seekp(0);
+	out.write((const char*)&header, sizeof(header));
+	out.close();
+
+	if (out)
+	{
+		run.mapping = mapModelFile(run.fileName, run.fileBytes);
+	}
+	if (run.mapping == nullptr)
+	{
+		cerr << "Cannot write to " << run.fileName << endl;
+		remove(run.fileName.c_str());
+		return 0;
+	}
+
+	run.packed = (const unsigned long long*)(run.mapping + sizeof(RunHeader));
+	run.longWords = (const char*)(run.packed + run.packedCount);
+
+	return 1;
+}
+
+// Unmaps run and removes its file
+void UniqueWordSet::dropRun(SpilledRun& run)
+{
+	unmapModelFile(run.mapping, run.fileBytes);
+	remove(run.fileName.c_str());
+}
+
+
+
+// Returns word packed 6 bits a letter with its first letter highest, or 0 if it is too long or not all letters
+unsigned long long UniqueWordSet::packWord(const char word[], int& length)
+{
+	unsigned long long	packed = 0;
+	int			letter;
+
+
+	for (length = 0; word[length] != '\0'; ++length)
+	{
+		if ((word[length] >= 'a') && (word[length] <= 'z'))
+		{
+			letter = 1 + (word[length] - 'a');
+		}
+		else if ((word[length] >= 'A') && (word[length] <= 'Z'))
+		{
+			letter = 27 + (word[length] - 'A');
+		}
+		else
+		{
+			letter = 0;
+		}
+
+		if ((letter == 0) || (length >= UNIQUE_PACKED_LETTERS))
+		{
+			packed = 0;
+			length += strlen(word + length);
+			break;
+		}
+		packed |= (unsigned long long)letter << (6 * (UNIQUE_PACKED_LETTERS - 1 - length));
+	}
+
+	return packed;
+}
+
+// Returns the 64-bit hash of a word longer than UNIQUE_PACKED_LETTERS (64-bit FNV-1a and a murmur3 finalizer)
+unsigned long long UniqueWordSet::hashLongWord(const char word[])
+{
+	unsigned long long	hash = 14695981039346656037ULL;
+	int			i;
+
+
+	for (i = 0; word[i] != '\0'; ++i)
+	{
+		hash ^= (unsigned char)word[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hashPacked(hash);
+}
+
+// Returns a packed key with every bit mixed into every other (the murmur3 finalizer)
+unsigned long long UniqueWordSet::hashPacked(const unsigned long long& packed)
+{
+	unsigned long long	hash = packed;
+
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
\ No newline at end of file
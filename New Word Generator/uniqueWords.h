@@ -0,0 +1,162 @@
+#pragma once
+#include "utilities.h"
+#include <atomic>
+#include <vector>
+
+
+// UNIQUE WORD SET SETTINGS
+const long UNIQUE_DEFAULT_CAP = 256L << 20;	// Most bytes the set keeps in memory when no cap is given
+const long UNIQUE_SMALLEST_CAP = 1L << 16;	// Caps below this are raised to it
+const int UNIQUE_PACKED_LETTERS = 10;		// Longest word packed straight into a key, 6 bits a letter
+const int UNIQUE_FENCE_WORDS = 64;		// Spilled long words between two in-memory fences
+const unsigned long long UNIQUE_LONG_KEY = 1ULL << 63;	// Marks a key holding an arena offset instead of letters
+const int UNIQUE_OFFSET_BITS = 40;		// Low bits of a long key holding its arena offset (the rest up to bit 63 hold hash bits)
+const char UNIQUE_RUN_MAGIC[8] = { 'R', 'W', 'U', 'N', 'I', 'Q', 'U', '1' };	// First 8 bytes of every spilled run
+
+
+// The words a run has produced so far, shared by every generator thread
+//
+// Words are kept in one open-addressing table of 64-bit keys that threads claim with a
+// compare-and-swap, so between spills inserts never wait on each other. Words of up to UNIQUE_PACKED_LETTERS
+// letters are packed into the key itself; longer words are copied into an arena claimed with
+// an atomic add, and the key holds their arena offset and part of their hash.
+//
+// Memory is bounded by the cap: half of it for the table (kept at most half full), a quarter for
+// the arena, and a quarter for sorting when the table spills. A spill happens once the table or the
+// arena fills: every thread is held at the door, the words are sorted and written to a run file in
+// the spill directory, the file is mapped read-only, and the table starts over empty. A spill stops
+// every inserting thread until the run is written and merged, so the set is only lock-free between
+// spills; a larger cap makes them rarer. Words are then
+// looked up in the table and in every run (a binary search over the packed keys, and over fences every
+// UNIQUE_FENCE_WORDS long words), so the set stays exact. After each spill the newest run is merged with
+// the one before while that one is no more than twice its size, which keeps about log2(spills) runs to
+// search. The run files are removed when the set is destroyed.
+class UniqueWordSet
+{
+public:
+	// Constructor
+	// memoryCap is the most bytes to keep in memory (0 for UNIQUE_DEFAULT_CAP), and runs are spilled
+	// into spillDirectory (empty for the system's temporary directory)
+	UniqueWordSet(const long& memoryCap, const string& spillDirectory);
+	//
+	// A copy would remove the same run files when destroyed, so a set can't be copied
+	UniqueWordSet(const UniqueWordSet&) = delete;
+	UniqueWordSet& operator=(const UniqueWordSet&) = delete;
+	//
+	// Destructor
+	~UniqueWordSet();
+
+	// Adds word to the set, spilling first if the table is full
+	// Returns 1 if word is new, 0 if it was already in the set, or -1 if a run could not be written
+	int insert(const char word[]);
+
+	// Returns the number of words inserted
+	long long wordCount() const;
+	//
+	// Returns the number of inserts turned away as duplicates
+	long long duplicateCount() const;
+	//
+	// Returns the number of runs on disk (merged runs count once)
+	int runCount() const;
+	//
+	// Displays the counts above to out
+	void display(ostream& out) const;
+
+private:
+	// The start of a spilled run, followed by the sorted packed keys and then the sorted long words
+	struct RunHeader
+	{
+		char		magic[8];	// UNIQUE_RUN_MAGIC
+		long long	packedCount;	// Packed keys after the header
+		long long	longCount;	// Null-terminated long words after the keys
+		long long	longBytes;	// Chars of the long words, nulls included
+	};
+
+	// One spilled run, mapped read-only
+	struct SpilledRun
+	{
+		string			fileName;	// Where the run was written
+		const char*		mapping;	// The whole file
+		long long		fileBytes;	// Size of the whole file
+		const unsigned long long*	packed;	// Sorted packed keys
+		long long		packedCount;
+		const char*		longWords;	// Sorted long words, each after the one before's null
+		long long		longCount;
+		long long		longBytes;
+		vector<long long>	fences;		// Offset into longWords of every UNIQUE_FENCE_WORDS-th long word
+	};
+
+	atomic<unsigned long long>*	_slots;		// The table (0 for an empty slot)
+	long long		_slotMask;	// Slot count - 1 (a power of 2)
+	long long		_maxUsed;	// Slots used before the table spills
+	atomic<long long>	_used;		// Slots used
+	char*			_arena;		// Long words, each followed by a null
+	long long		_arenaBytes;	// Chars _arena can hold
+	atomic<long long>	_arenaUsed;	// Chars claimed from _arena (may run past _arenaBytes once it fills)
+	atomic<int>		_active;	// Threads inside the table
+	atomic<bool>		_spilling;	// A thread is spilling, so no other may enter the table
+	atomic<bool>		_failed;	// A run could not be written, so the set takes no more words
+	atomic<long long>	_words;		// Words inserted
+	atomic<long long>	_duplicates;	// Inserts turned away
+	vector<SpilledRun>	_runs;		// Runs spilled so far, only changed while spilling
+	string			_spillDirectory;	// Where runs are written
+	long long		_runStamp;	// Part of every run file name, so sets never share a file
+	int			_runFiles;	// Run files written so far, merged ones included
+
+
+
+	// TABLE ACCESS
+	//
+	// Waits for any spill to finish and enters the table
+	void enterTable();
+	//
+	// Leaves the table
+	void leaveTable();
+	//
+	// Looks word up and claims a slot for it if it is new, with the table entered
+	// Returns 1 if word is new, 0 if it was already in the set, or -1 if the arena is full
+	int tryInsert(const char word[], const unsigned long long& packed, const unsigned long long& hash, const int& length);
+	//
+	// Check if a spilled run holds word (packed as packed, or 0 if it is too long to pack)
+	// Returns true if any run holds it
+	bool inRuns(const char word[], const unsigned long long& packed) const;
+
+	// SPILLING
+	//
+	// Holds every other thread out of the table and writes it to a new run if it is still full
+	// Returns 0 if the run could not be written, 1 for success
+	int spill();
+	//
+	// Sorts the table's words into a new run file and maps it into run
+	// Returns 0 for failure, 1 for success
+	int writeRun(SpilledRun& run);
+	//
+	// Merges older and newer into a new run file and maps it into merged
+	// Returns 0 for failure, 1 for success
+	int mergeRuns(const SpilledRun& older, const SpilledRun& newer, SpilledRun& merged);
+	//
+	// Opens a new run file for run, leaving room for its header
+	// Returns 0 for failure, 1 for success
+	int startRun(ofstream& out, SpilledRun& run);
+	//
+	// Appends a long word to a run being written, adding a fence every UNIQUE_FENCE_WORDS words
+	static void addLongWord(ofstream& out, const char word[], SpilledRun& run);
+	//
+	// Writes the header of a run being written, closes it, and maps it into run
+	// Returns 0 for failure, 1 for success
+	static int finishRun(ofstream& out, SpilledRun& run);
+	//
+	// Unmaps run and removes its file
+	static void dropRun(SpilledRun& run);
+
+	// KEYS
+	//
+	// Returns word packed 6 bits a letter with its first letter highest, or 0 if it is too long or not all letters
+	static unsigned long long packWord(const char word[], int& length);
+	//
+	// Returns the 64-bit hash of a word longer than UNIQUE_PACKED_LETTERS (64-bit FNV-1a and a murmur3 finalizer)
+	static unsigned long long hashLongWord(const char word[]);
+	//
+	// Returns a packed key with every bit mixed into every other (the murmur3 finalizer)
+	static unsigned long long hashPacked(const unsigned long long& packed);
+};
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "selfTest.h"
+#include "uniqueWords.h"
+#include "letterSampler.h"
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+// UNIQUE WORDS TEST SETTINGS
+const int UNIQUE_TEST_WORDS = 30000;		// Different words inserted, enough to spill the smallest cap many times
+const int UNIQUE_TEST_THREADS = 4;		// Threads inserting the same words at once
+
+
+
+// Writes the wordNumber-th test word into word, a short word that packs into a key or a long one kept in the arena
+static void uniqueWord(const int& wordNumber, const bool& longWord, char word[])
+{
+	int	number = wordNumber;
+	int	length = 0;
+
+
+	if (longWord)
+	{
+		stringCopy(word, MAX_CHAR, "unpackable");
+		length = (int)strlen(word);
+	}
+	do
+	{
+		word[length++] = (char)('a' + (number % LETTER_COUNT));
+		number /= LETTER_COUNT;
+	} while (number > 0);
+	word[length] = '\0';
+}
+
+// Inserts the first wordCount test words, alternating short and long, into words
+// Returns how many of the inserts returned result
+static int insertWords(UniqueWordSet& words, const int& wordCount, const int& result)
+{
+	char	word[MAX_CHAR];
+	int	matching = 0;
+	int	i;
+
+
+	for (i = 0; i < wordCount; ++i)
+	{
+		uniqueWord(i, (i % 2) == 1, word);
+		matching += (words.insert(word) == result);
+	}
+
+	return matching;
+}
+
+// Returns the number of files in directory
+static int countFiles(const string& directory)
+{
+	error_code	error;
+	int		files = 0;
+
+
+	for (filesystem::directory_iterator i(directory, error); (!error) && (i != filesystem::directory_iterator()); i.increment(error))
+	{
+		++files;
+	}
+
+	return files;
+}
+
+// Checks that words stay unique across spills and merges, and that the run files are removed afterwards
+static void testSpills(const string& directory)
+{
+	{
+		UniqueWordSet	words(UNIQUE_SMALLEST_CAP, directory);
+		char		word[MAX_CHAR];
+
+		selfCheck(insertWords(words, UNIQUE_TEST_WORDS, 1) == UNIQUE_TEST_WORDS, "every new word is added across spills");
+		selfCheck((words.runCount() >= 1) && (countFiles(directory) == words.runCount()), "a full table spills into run files");
+		selfCheck(words.runCount() <= 6, "runs of similar size are merged");
+		selfCheck((insertWords(words, UNIQUE_TEST_WORDS, 0) == UNIQUE_TEST_WORDS) && (words.duplicateCount() == UNIQUE_TEST_WORDS),
+			"every word already added is found again, spilled or not");
+
+		uniqueWord(UNIQUE_TEST_WORDS, false, word);
+		selfCheck((words.insert(word) == 1) && (words.wordCount() == UNIQUE_TEST_WORDS + 1), "a word never added is still new");
+	}
+
+	selfCheck(countFiles(directory) == 0, "the run files are removed with the set");
+}
+
+// Checks that threads inserting the same words at once add each one once
+static void testThreads(const string& directory)
+{
+	UniqueWordSet	words(UNIQUE_SMALLEST_CAP, directory);
+	int		added[UNIQUE_TEST_THREADS] = { 0 };
+	vector<thread>	inserters;
+	int		total = 0;
+	int		i;
+
+
+	for (i = 0; i < UNIQUE_TEST_THREADS; ++i)
+	{
+		inserters.push_back(thread([&words, &added, i]() { added[i] = insertWords(words, UNIQUE_TEST_WORDS, 1); }));
+	}
+	for (i = 0; i < UNIQUE_TEST_THREADS; ++i)
+	{
+		inserters[i].join();
+		total += added[i];
+	}
+
+	selfCheck((total == UNIQUE_TEST_WORDS) && (words.wordCount() == UNIQUE_TEST_WORDS), "threads racing on the same words add each once");
+	selfCheck(words.duplicateCount() == (long long)UNIQUE_TEST_WORDS * (UNIQUE_TEST_THREADS - 1), "every other racing insert is a duplicate");
+}
+
+// Checks that a run that can't be written stops the set instead of losing words
+static void testUnwritable(const string& directory)
+{
+	UniqueWordSet	words(UNIQUE_SMALLEST_CAP, directory + "/missing");
+	char		word[MAX_CHAR];
+	int		result = 1;
+	int		i;
+
+
+	for (i = 0; (i < UNIQUE_TEST_WORDS) && (result == 1); ++i)
+	{
+		uniqueWord(i, false, word);
+		result = words.insert(word);
+	}
+
+	selfCheck((result == -1) && (words.insert("another") == -1), "a run that can't be written is reported, and the set takes no more words");
+}
+
+
+
+// Inserting, spilling, and merging of the unique word set
+void testUniqueWords()
+{
+	string		directory = selfTestPath("spill");
+	stringstream	errors;
+	streambuf*	cerrBuffer;
+	error_code	error;
+
+
+	filesystem::remove_all(directory, error);
+	if (!selfCheck(filesystem::create_directory(directory, error), "make the spill directory"))
+	{
+		return;
+	}
+
+	testSpills(directory);
+	testThreads(directory);
+
+	cerrBuffer = cerr.rdbuf(errors.rdbuf());
+	testUnwritable(directory);
+	cerr.rdbuf(cerrBuffer);
+
+	filesystem::remove_all(directory, error);
+}
\ No newline at end of file
@@ -1,4 +1,57 @@
 #include "utilities.h"
+#include <cerrno>
+
+// SSE2 is part of every x86-64 target, so the 16-chars-at-a-time paths are used there
+// and the plain loops everywhere else
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define CSTRING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Lowercases 16 ASCII chars at once, leaving every other char as it is
+#ifdef CSTRING_SSE2
+static inline __m128i lowercaseBlock(const __m128i& block)
+{
+        const __m128i   upperA = _mm_set1_epi8('A' - 1);
+        const __m128i   upperZ = _mm_set1_epi8('Z' + 1);
+        const __m128i   caseBit = _mm_set1_epi8(0x20);
+        __m128i         isUpper;
+
+        isUpper = _mm_and_si128(_mm_cmpgt_epi8(block, upperA), _mm_cmplt_epi8(block, upperZ));
+
+        return _mm_or_si128(block, _mm_and_si128(isUpper, caseBit));
+}
+#endif
+
+// Returns the lowercase of an ASCII char, leaving every other char as it is
+static inline char lowercaseChar(const char& aChar)
+{
+        return ((aChar >= 'A') && (aChar <= 'Z')) ? (aChar | 0x20) : aChar;
+}
+
+// Compares chars i to stringLength - 1 of the cstrings without regard to case
+// Returns true if they match
+static inline bool compareLowercaseFrom(const char cString1[], const char cString2[], int i, const int& stringLength)
+{
+        for (; i < stringLength; i++)
+        {
+                if (lowercaseChar(cString1[i]) != lowercaseChar(cString2[i]))
+                {
+                        return false;
+                }
+        }
+
+        return true;
+}
+
+// Lowercases chars i to stringLength - 1 of the cstring in place
+static inline void lowercaseFrom(char cString[], int i, const int& stringLength)
+{
+        for (; i < stringLength; i++)
+        {
+                cString[i] = lowercaseChar(cString[i]);
+        }
+}
 
 //ERROR UTILITIES
 //
@@ -148,6 +201,37 @@ void takeInput(char input[], const string& prompt, int& stringLength)
         stringLength = strlen(input);
 }
 
+// Read a line of a file
+//
+// Reads the next line of in into line (MAX_CHAR chars), cutting a longer line at MAX_CHAR - 1 chars
+// An empty line reads as "" like any other, where in.get() alone would stop the stream,
+// and the '\r' of a file saved with Windows (CRLF) line endings is dropped
+// Returns false once there are no more lines
+bool readLine(ifstream& in, char line[])
+{
+        size_t  length;
+
+        line[0] = '\0';
+        in.get(line, MAX_CHAR, '\n');
+
+        length = strlen(line);
+        if ((length > 0) && (line[length - 1] == '\r'))
+        {
+                line[length - 1] = '\0';
+        }
+
+        // An empty line reads nothing, which get() reports as a failure
+        if ((in.fail()) && (!in.eof()))
+        {
+                in.clear();
+        }
+
+        // Drop the newline, and the rest of a line too long for line
+        in.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        return ((line[0] != '\0') || (!in.eof()));
+}
+
 // CHECK FOR QUIT
 //
 // Check for entry of 'q' for quit for cstring input.
@@ -178,17 +262,11 @@ bool quitCheck(const char& input)
 }
 
 // OUTPUT UTILITIES
+//
+// Writes the whole cstring to cout in one call
 void printCstring(const char cString[])
 {
-        int     i;
-        int     length;
-
-        length = strlen(cString);
-
-        for (i = 0; i < length; i++)
-        {
-                cout << cString[i];
-        }
+        cout.write(cString, strlen(cString));
 }
 
 void copyCstring(const char sourceCstring[], char destinationCstring[])
@@ -225,58 +303,77 @@ int compareChar(const char& char1, const char& char2)
         return comparisonReturner;
 }
 
-int compareCstringToLowercase(const char cString1[], const char cString2[])
+// Compares the cstrings without regard to case, without copying either one
+// Returns true if they match
+bool compareCstringToLowercase(const char cString1[], const char cString2[])
 {
-        int     stringLength1;
-        int     stringLength2;
-        char* cString1Lowercase;
-        char* cString2Lowercase;
-        bool    matchFlag;
+        int     stringLength;
+        int     i = 0;
 
-        stringLength1 = strlen(cString1);
-        stringLength2 = strlen(cString2);
-        matchFlag = false;
 
         // If the strings are not the same length the strings are not the same
-        if (strlen(cString1) != strlen(cString2))
+        stringLength = strlen(cString1);
+        if (stringLength != (int)strlen(cString2))
         {
-                matchFlag = false;
+                return false;
         }
-        else
-        {
-                cString1Lowercase = new char[stringLength1 + 1];
-                cString2Lowercase = new char[stringLength2 + 1];
 
-                stringCopy(cString1Lowercase, (stringLength1 + 1), cString1);
-                stringCopy(cString2Lowercase, (stringLength2 + 1), cString2);
-
-                // Change cstring to lowercase for comparison
-                cStringToLowercase(cString1Lowercase, stringLength1);
-                cStringToLowercase(cString2Lowercase, stringLength2);
+#ifdef CSTRING_SSE2
+        // Compare 16 lowercased chars at a time
+        for (; i + 16 <= stringLength; i += 16)
+        {
+                __m128i block1 = lowercaseBlock(_mm_loadu_si128((const __m128i*)(cString1 + i)));
+                __m128i block2 = lowercaseBlock(_mm_loadu_si128((const __m128i*)(cString2 + i)));
 
-                if (!strcmp(cString1Lowercase, cString2Lowercase))
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(block1, block2)) != 0xFFFF)
                 {
-                        matchFlag = true;
+                        return false;
                 }
-                else
-                {
-                        matchFlag = false;
-                }
-                delete[] cString1Lowercase;
-                delete[] cString2Lowercase;
         }
-        return matchFlag;
+#endif
+
+        // Then whatever is left one char at a time
+        return compareLowercaseFrom(cString1, cString2, i, stringLength);
+}
+
+// Compares the cstrings without regard to case one char at a time, as targets without SSE2 do
+// Returns true if they match
+bool compareCstringToLowercaseScalar(const char cString1[], const char cString2[])
+{
+        int     stringLength;
+
+        stringLength = strlen(cString1);
+        if (stringLength != (int)strlen(cString2))
+        {
+                return false;
+        }
+
+        return compareLowercaseFrom(cString1, cString2, 0, stringLength);
 }
 
 // Cstring manipulation
+//
+// Lowercases the first stringLength chars of the cstring in place
 void cStringToLowercase(char cString[], const int stringLength)
 {
-        int     i;
+        int     i = 0;
 
-        for (i = 0; i < stringLength; i++)
+#ifdef CSTRING_SSE2
+        // Lowercase 16 chars at a time
+        for (; i + 16 <= stringLength; i += 16)
         {
-                cString[i] = tolower(cString[i]);
+                _mm_storeu_si128((__m128i*)(cString + i), lowercaseBlock(_mm_loadu_si128((const __m128i*)(cString + i))));
         }
+#endif
+
+        // Then whatever is left one char at a time
+        lowercaseFrom(cString, i, stringLength);
+}
+
+// Lowercases the first stringLength chars of the cstring in place one char at a time, as targets without SSE2 do
+void cStringToLowercaseScalar(char cString[], const int stringLength)
+{
+        lowercaseFrom(cString, 0, stringLength);
 }
 
 // Take a cString input, check for validity, and 
@@ -294,10 +391,42 @@ bool cStringToInt(const char inputCstring[], int& outputInteger)
         }
 }
 
+// Converts all of inputCstring, a whole number in base 10, into outputNumber
+// Returns false (leaving outputNumber at 0) if anything but the number is there or it doesn't fit in a long
+bool cStringToLong(const char inputCstring[], long& outputNumber)
+{
+        char*   end;
+
+        errno = 0;
+        outputNumber = strtol(inputCstring, &end, 10);
+        if ((end == inputCstring) || (*end != '\0') || (errno == ERANGE))
+        {
+                outputNumber = 0;
+                return false;
+        }
+
+        return true;
+}
+
+// Copies source into destination, which holds stringLength chars including the null
+// A source that doesn't fit is cut short, and destination is always null terminated
 void stringCopy(char destination[], const int& stringLength, const char source[])
 {
-        //strcpy(destination, source);
-        strcpy_s(destination, stringLength, source);
+        size_t  copyLength;
+
+        if (stringLength <= 0)
+        {
+                return;
+        }
+
+        copyLength = strlen(source);
+        if (copyLength > (size_t)(stringLength - 1))
+        {
+                copyLength = stringLength - 1;
+        }
+
+        memcpy(destination, source, copyLength);
+        destination[copyLength] = '\0';
 }
 
 // Design Tools
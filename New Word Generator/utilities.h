@@ -1,9 +1,12 @@
+#pragma once
 #include <iostream>
 using namespace std;
 #include <cstring>
 #include <string>
 #include <time.h>
 #include <fstream>
+#include <algorithm>
+#include <limits>
 
 const int MAX_CHAR = 256;
 const int BOX_WIDTH = 72;
@@ -14,6 +17,12 @@ void takeInput(int& input, const string& prompt);
 void takeInput(double& input, const string& prompt);
 void takeInput(char& input, const string& prompt);
 void takeInput(char input[], const string& prompt);
+//
+// Reads the next line of in into line (MAX_CHAR chars), cutting a longer line at MAX_CHAR - 1 chars
+// An empty line reads as "" like any other, where in.get() alone would stop the stream,
+// and the '\r' of a file saved with Windows (CRLF) line endings is dropped
+// Returns false once there are no more lines
+bool readLine(ifstream& in, char line[]);
 
 // Error Handling
 //
@@ -23,19 +32,36 @@ void invalidEntry(const bool& errorFlag);
 bool quitCheck(const char input[]);
 bool quitCheck(const char& input);
 
-// Cstring Utilities
+// Output Utilities
 //
-// Cstring General Output
+// Writes the whole cstring to cout in one call
 void printCstring(const char cString[]);
-int compareCstringToLowercase(const char cString1[], const char cString2[]);
+
+// Cstring Utilities
+//
+// Lowercasing is ASCII-only, like tolower() in the default C locale. Where the target has SSE2
+// (every x86-64 build) 16 chars are handled at a time, and the Scalar versions show what every
+// other target runs.
 //
 // Cstring Copy
 void copyCstring(const char sourceCstring[], char destinationCstring[]);
 int compareChar(const char& char1, const char& char2);
 //
-// Cstring manipulation
+// Compares the cstrings without regard to case, without copying either one
+// Returns true if they match
+bool compareCstringToLowercase(const char cString1[], const char cString2[]);
+bool compareCstringToLowercaseScalar(const char cString1[], const char cString2[]);
+//
+// Lowercases the first stringLength chars of the cstring in place
 void cStringToLowercase(char cString[], const int stringLength);
+void cStringToLowercaseScalar(char cString[], const int stringLength);
+//
+// Cstring manipulation
 bool cStringToInt(const char input[], int& output);
+//
+// Converts all of input, a whole number in base 10, into output
+// Returns false (leaving output at 0) if anything but the number is there or it doesn't fit in a long
+bool cStringToLong(const char input[], long& output);
 void stringCopy(char destination[], const int& stringLength, const char source[]);
 
 // Design Tools
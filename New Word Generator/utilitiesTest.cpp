@@ -0,0 +1,129 @@
+#include "selfTest.h"
+#include <sstream>
+
+using namespace std;
+
+// Lengths that fall before, on, and after the 16-char blocks of the SSE2 paths
+static const int CSTRING_TEST_LENGTHS[] = { 0, 1, 15, 16, 17, 31, 32, 33 };
+
+// Fills cString with length chars mixing both cases, digits, the chars beside 'A' to 'Z' and 'a' to 'z',
+// and chars above 127, then null terminates it
+static void fillMixedCstring(char cString[], const int& length)
+{
+	const char	pool[] = "aZ@[`{0 Mq\x80\xC1zA";
+	int		i;
+
+	for (i = 0; i < length; ++i)
+	{
+		cString[i] = pool[(i * 7 + length) % (sizeof(pool) - 1)];
+	}
+	cString[length] = '\0';
+}
+
+// Checks the SSE2 lowercase and compare against the scalar versions at every test length
+static void testLowercase()
+{
+	char	mixed[64];
+	char	vectorLower[64];
+	char	scalarLower[64];
+	char	other[64];
+	bool	lowercaseMatches = true;
+	bool	comparesMatch = true;
+	bool	comparesRight = true;
+	int	length;
+	int	i;
+	int	j;
+
+
+	for (i = 0; i < (int)(sizeof(CSTRING_TEST_LENGTHS) / sizeof(CSTRING_TEST_LENGTHS[0])); ++i)
+	{
+		length = CSTRING_TEST_LENGTHS[i];
+		fillMixedCstring(mixed, length);
+		memcpy(vectorLower, mixed, length + 1);
+		memcpy(scalarLower, mixed, length + 1);
+		cStringToLowercase(vectorLower, length);
+		cStringToLowercaseScalar(scalarLower, length);
+		lowercaseMatches = lowercaseMatches && (!memcmp(vectorLower, scalarLower, length + 1));
+
+		// The same string in other case matches
+		comparesRight = comparesRight && compareCstringToLowercase(mixed, vectorLower) && compareCstringToLowercaseScalar(mixed, vectorLower);
+
+		// A change at any one position, including '@' against '`' which differ only in the case bit, doesn't
+		for (j = 0; j < length; ++j)
+		{
+			memcpy(other, mixed, length + 1);
+			other[j] = (other[j] == '@') ? '`' : '@';
+			comparesMatch = comparesMatch && (compareCstringToLowercase(mixed, other) == compareCstringToLowercaseScalar(mixed, other));
+			comparesRight = comparesRight && (!compareCstringToLowercase(mixed, other));
+		}
+
+		// Nor does a string one char longer
+		memcpy(other, mixed, length + 1);
+		other[length] = 'a';
+		other[length + 1] = '\0';
+		comparesRight = comparesRight && (!compareCstringToLowercase(mixed, other)) && (!compareCstringToLowercaseScalar(other, mixed));
+	}
+
+	selfCheck(lowercaseMatches, "cStringToLowercase() matches the scalar version at lengths 0 to 33");
+	selfCheck(comparesMatch, "compareCstringToLowercase() agrees with the scalar version at every position");
+	selfCheck(comparesRight, "compareCstringToLowercase() matches only the same string in any case");
+
+	// Only 'A' to 'Z' change, even among chars above 127
+	fillMixedCstring(mixed, 33);
+	memcpy(vectorLower, mixed, 34);
+	cStringToLowercase(vectorLower, 33);
+	lowercaseMatches = true;
+	for (i = 0; i < 33; ++i)
+	{
+		lowercaseMatches = lowercaseMatches && (vectorLower[i] == (((mixed[i] >= 'A') && (mixed[i] <= 'Z')) ? (char)(mixed[i] + ('a' - 'A')) : mixed[i]));
+	}
+	selfCheck(lowercaseMatches, "cStringToLowercase() changes only 'A' to 'Z'");
+}
+
+// Checks printCstring() writes the whole string and nothing more
+static void testPrint()
+{
+	stringstream	output;
+	streambuf*	saved;
+
+
+	saved = cout.rdbuf(output.rdbuf());
+	printCstring("Hello, words");
+	printCstring("");
+	cout.rdbuf(saved);
+
+	selfCheck(output.str() == "Hello, words", "printCstring() writes the whole cstring");
+}
+
+
+
+// Cstring utilities: copying, comparing, lowercasing, converting, and printing
+void testUtilities()
+{
+	char	destination[8];
+	int	number = 0;
+	long	bytes = 0;
+
+
+	memset(destination, 'x', sizeof(destination));
+	stringCopy(destination, sizeof(destination), "abc");
+	selfCheck(!strcmp(destination, "abc"), "stringCopy() copies a source that fits");
+
+	memset(destination, 'x', sizeof(destination));
+	stringCopy(destination, sizeof(destination), "abcdefghijkl");
+	selfCheck(!strcmp(destination, "abcdefg"), "stringCopy() cuts a long source short and null terminates it");
+
+	memset(destination, 'x', sizeof(destination));
+	stringCopy(destination, 0, "abc");
+	selfCheck(destination[0] == 'x', "stringCopy() writes nothing into no room");
+
+	selfCheck((compareChar('a', 'B') == -1) && (compareChar('Q', 'q') == 0) && (compareChar('z', 'A') == 1),
+		"compareChar() orders chars without regard to case");
+	selfCheck((cStringToInt("1234", number)) && (number == 1234), "cStringToInt() converts a number");
+	selfCheck((cStringToLong("67108864", bytes)) && (bytes == 67108864), "cStringToLong() converts a number");
+	selfCheck((!cStringToLong("64M", bytes)) && (bytes == 0) && (!cStringToLong("x", bytes)) && (!cStringToLong("", bytes))
+		&& (!cStringToLong("99999999999999999999999", bytes)), "cStringToLong() refuses a suffix, letters, nothing, and a number too large");
+
+	testLowercase();
+	testPrint();
+}
\ No newline at end of file
@@ -0,0 +1,422 @@
+#include "verify.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+using namespace std;
+
+// Returns the regularized upper incomplete gamma function Q(a, x)
+// (series below a + 1, continued fraction above, as in Numerical Recipes)
+static double gammaQ(const double& a, const double& x)
+{
+	double	sum;
+	double	term;
+	double	b;
+	double	c;
+	double	d;
+	double	h;
+	double	an;
+	int	i;
+
+
+	if ((x <= 0) || (a <= 0))
+	{
+		return 1;
+	}
+
+	if (x < a + 1)
+	{
+		sum = 1 / a;
+		term = sum;
+		for (i = 1; i < 1000; ++i)
+		{
+			term *= x / (a + i);
+			sum += term;
+			if (fabs(term) < fabs(sum) * 1e-15)
+			{
+				break;
+			}
+		}
+		return 1 - (sum * exp(-x + a * log(x) - lgamma(a)));
+	}
+
+	b = x + 1 - a;
+	c = 1 / 1e-300;
+	d = 1 / b;
+	h = d;
+	for (i = 1; i < 1000; ++i)
+	{
+		an = -i * (i - a);
+		b += 2;
+		d = an * d + b;
+		d = (fabs(d) < 1e-300) ? 1e-300 : d;
+		c = b + an / c;
+		c = (fabs(c) < 1e-300) ? 1e-300 : c;
+		d = 1 / d;
+		h *= d * c;
+		if (fabs(d * c - 1) < 1e-15)
+		{
+			break;
+		}
+	}
+
+	return exp(-x + a * log(x) - lgamma(a)) * h;
+}
+
+// Runs a chi-square test that counts a and b (cells long) come from the same distribution
+// Cells expecting fewer than VERIFY_MIN_EXPECTED words in either sample are pooled into one
+// Returns the p-value and sets statistic and degrees
+static double chiSquareHomogeneity(const long long a[], const long long b[], const int& cells, double& statistic, int& degrees)
+{
+	double		totalA = 0;
+	double		totalB = 0;
+	double		pooledA = 0;		// Counts of the pooled cells
+	double		pooledB = 0;
+	double		expectedA;
+	double		expectedB;
+	int		usedCells = 0;
+	int		i;
+
+
+	for (i = 0; i < cells; ++i)
+	{
+		totalA += a[i];
+		totalB += b[i];
+	}
+
+	statistic = 0;
+	degrees = 0;
+	if ((totalA == 0) || (totalB == 0))
+	{
+		return 1;
+	}
+
+	for (i = 0; i < cells; ++i)
+	{
+		expectedA = (a[i] + b[i]) * totalA / (totalA + totalB);
+		expectedB = (a[i] + b[i]) * totalB / (totalA + totalB);
+
+		if ((expectedA < VERIFY_MIN_EXPECTED) || (expectedB < VERIFY_MIN_EXPECTED))
+		{
+			pooledA += a[i];
+			pooledB += b[i];
+		}
+		else
+		{
+			statistic += ((a[i] - expectedA) * (a[i] - expectedA) / expectedA) + ((b[i] - expectedB) * (b[i] - expectedB) / expectedB);
+			++usedCells;
+		}
+	}
+
+	expectedA = (pooledA + pooledB) * totalA / (totalA + totalB);
+	expectedB = (pooledA + pooledB) * totalB / (totalA + totalB);
+	if ((expectedA >= VERIFY_MIN_EXPECTED) && (expectedB >= VERIFY_MIN_EXPECTED))
+	{
+		statistic += ((pooledA - expectedA) * (pooledA - expectedA) / expectedA) + ((pooledB - expectedB) * (pooledB - expectedB) / expectedB);
+		++usedCells;
+	}
+
+	degrees = usedCells - 1;
+	if (degrees < 1)
+	{
+		return 1;
+	}
+
+	return gammaQ(degrees / 2.0, statistic / 2);
+}
+
+// Runs a two-sample Kolmogorov-Smirnov test on the length histograms of a and b
+// Returns true if they pass at VERIFY_ALPHA and sets distance to the largest gap between their cumulative shares
+static bool kolmogorovSmirnov(const VerifySample& a, const VerifySample& b, double& distance, double& limit)
+{
+	double	sharedA = 0;
+	double	sharedB = 0;
+	int	i;
+
+
+	distance = 0;
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		sharedA += (double)a.lengths[i] / a.words;
+		sharedB += (double)b.lengths[i] / b.words;
+		distance = max(distance, fabs(sharedA - sharedB));
+	}
+
+	limit = VERIFY_KS_COEFFICIENT * sqrt((double)(a.words + b.words) / ((double)a.words * b.words));
+
+	return (distance <= limit);
+}
+
+// Displays one chi-square result
+// Returns 0 if it failed, 1 if it passed
+static int reportChiSquare(const string& test, const double& pValue, const double& statistic, const int& degrees)
+{
+	bool	passed = (pValue >= VERIFY_ALPHA);
+
+	cout << "  " << left << setw(22) << test << right << "chi2 = " << setw(10) << fixed << setprecision(1) << statistic;
+	cout << "  df = " << setw(4) << degrees << "  p = " << setprecision(4) << pValue << "  " << (passed ? "PASS" : "FAIL") << endl;
+
+	return passed ? 1 : 0;
+}
+
+// Generates wordCount words into sample with aRandomWord, timing the whole run
+static void sampleGenerator(RandomWord& aRandomWord, const long long& wordCount, VerifySample& sample)
+{
+	chrono::steady_clock::time_point	start;
+	long long				i;
+
+
+	clearVerifySample(sample);
+
+	start = chrono::steady_clock::now();
+	for (i = 0; i < wordCount; ++i)
+	{
+		if (aRandomWord.generate() != 0)
+		{
+			addVerifyWord(sample, aRandomWord.word());
+		}
+	}
+	sample.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Generates wordCount words into sample with batchGenerator, VERIFY_BATCH_WORDS at a time, timing the whole run
+static void sampleBatches(BatchGenerator& batchGenerator, const int& maxLength, const long long& wordCount, VerifySample& sample)
+{
+	WordBatch				batch(VERIFY_BATCH_WORDS, maxLength);
+	char					bufferWord[MAX_CHAR];
+	chrono::steady_clock::time_point	start;
+	long long				wordsLeft = wordCount;
+	int					i;
+
+
+	clearVerifySample(sample);
+
+	start = chrono::steady_clock::now();
+	while (wordsLeft > 0)
+	{
+		batchGenerator.generate(batch, (int)min(wordsLeft, (long long)VERIFY_BATCH_WORDS));
+		for (i = 0; i < batch.size(); ++i)
+		{
+			batch.copyWord(i, bufferWord);
+			addVerifyWord(sample, bufferWord);
+		}
+		wordsLeft -= VERIFY_BATCH_WORDS;
+	}
+	sample.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+
+// Returns the fewest words per second generator name may make: the floor, or its baseline speed less the timing margin
+static double minimumSpeed(const string& name, const map<string, double>& baseline, const double& throughputFloor)
+{
+	map<string, double>::const_iterator	recorded = baseline.find(name);
+
+	return (recorded != baseline.end()) ? max(throughputFloor, recorded->second * VERIFY_SPEED_MARGIN) : throughputFloor;
+}
+
+// Returns the words per second sample was made at, or 0 if it took no measurable time
+static double sampleSpeed(const VerifySample& sample)
+{
+	return (sample.seconds > 0) ? (sample.words / sample.seconds) : 0;
+}
+
+
+
+// Generates wordCount words with every generator borrowing corpusOwner's donor list and lengths (nullptr for the default)
+// A candidate also fails if it makes fewer than throughputFloor words per second (0 for no floor), or runs slower
+// than VERIFY_SPEED_MARGIN of its speed in baselineFile (empty for no baseline)
+// The speeds of this run are written to recordFile (empty to skip) for a later run to compare with
+// Displays every test and returns 0 if any failed, 1 if all passed
+int runVerify(const RandomWord& corpusOwner, const LengthDistribution* lengths, const long long& wordCount, const double& throughputFloor,
+	const string& baselineFile, const string& recordFile)
+{
+	RandomWord		reference(&corpusOwner);
+	RandomWord		optimized(&corpusOwner);
+	BatchGenerator		batched(corpusOwner);
+	VerifySample		referenceSample;
+	VerifySample		optimizedSample;
+	VerifySample		batchedSample;
+	map<string, double>	baseline;
+	map<string, double>	speeds;
+	int			passed = 1;
+
+
+	if ((!baselineFile.empty()) && (readVerifyBaseline(baselineFile, baseline) == 0))
+	{
+		return 0;
+	}
+
+	headerBox("Verify");
+
+	// The reference is today's fillSection() algorithm with every shortcut turned off
+	reference.setReferenceMode(true);
+	reference.setLengthDistribution(lengths);
+	reference.seed(VERIFY_REFERENCE_SEED);
+	sampleGenerator(reference, wordCount, referenceSample);
+	cout << "reference: " << referenceSample.words << " words, " << fixed << setprecision(0) << sampleSpeed(referenceSample) << " words per second" << endl;
+	cout.unsetf(ios::floatfield);
+	cout << setprecision(6);
+
+	optimized.setLengthDistribution(lengths);
+	optimized.seed(VERIFY_CANDIDATE_SEED);
+	sampleGenerator(optimized, wordCount, optimizedSample);
+	passed &= compareVerifySamples(referenceSample, optimizedSample, "optimized", minimumSpeed("optimized", baseline, throughputFloor));
+
+	batched.setLengthDistribution(lengths);
+	batched.seed(VERIFY_CANDIDATE_SEED);
+	sampleBatches(batched, (lengths != nullptr) ? lengths->largest() : LARGEST_WORD, wordCount, batchedSample);
+	passed &= compareVerifySamples(referenceSample, batchedSample, "batched", minimumSpeed("batched", baseline, throughputFloor));
+
+	cout << (passed ? "All generators match the reference" : "Some generators differ from the reference") << endl;
+
+	if (!recordFile.empty())
+	{
+		speeds["optimized"] = sampleSpeed(optimizedSample);
+		speeds["batched"] = sampleSpeed(batchedSample);
+		passed &= writeVerifyBaseline(recordFile, speeds);
+	}
+
+	return passed;
+}
+
+// Reads the words per second of each generator from fileName into speeds
+// Returns 0 for failure, 1 for success
+int readVerifyBaseline(const string& fileName, map<string, double>& speeds)
+{
+	ifstream	in(fileName);
+	string		name;
+	double		speed;
+
+
+	if (!in)
+	{
+		cerr << "Cannot read from " << fileName << endl;
+		return 0;
+	}
+
+	speeds.clear();
+	while (in >> name >> speed)
+	{
+		speeds[name] = speed;
+	}
+	if (!in.eof())
+	{
+		cerr << "Error! " << fileName << " is not a verify baseline" << endl;
+		return 0;
+	}
+
+	return 1;
+}
+
+// Writes the words per second of each generator in speeds to fileName, one "name speed" line each
+// Returns 0 for failure, 1 for success
+int writeVerifyBaseline(const string& fileName, const map<string, double>& speeds)
+{
+	ofstream				out(fileName, ios::trunc);
+	map<string, double>::const_iterator	speed;
+
+
+	if (!out)
+	{
+		cerr << "Cannot write to " << fileName << endl;
+		return 0;
+	}
+
+	for (speed = speeds.begin(); speed != speeds.end(); ++speed)
+	{
+		out << speed->first << " " << fixed << setprecision(0) << speed->second << "\n";
+	}
+	out.close();
+
+	return (out) ? 1 : 0;
+}
+
+// Empties sample
+void clearVerifySample(VerifySample& sample)
+{
+	memset(&sample, 0, sizeof(sample));
+}
+
+// Counts word into sample
+void addVerifyWord(VerifySample& sample, const char word[])
+{
+	int	letter;
+	int	before = LETTER_NONE;	// letterIndex() of the letter before word[i]
+	int	i;
+
+
+	for (i = 0; word[i] != '\0'; ++i)
+	{
+		letter = letterIndex(word[i]);
+		if ((letter != LETTER_NONE) && (i < VERIFY_POSITIONS))
+		{
+			++sample.positions[i][letter];
+		}
+		if ((letter != LETTER_NONE) && (before != LETTER_NONE))
+		{
+			++sample.transitions[before][letter];
+		}
+		before = letter;
+	}
+
+	++sample.lengths[min(i, MAX_CHAR - 1)];
+	++sample.words;
+}
+
+// Compares candidate with reference and displays each test
+// The candidate fails if it makes fewer than minimumSpeed words per second (0 for no minimum)
+// Returns 0 if any test failed, 1 if all passed
+int compareVerifySamples(const VerifySample& reference, const VerifySample& candidate, const string& name, const double& minimumSpeed)
+{
+	double	statistic;
+	int	degrees;
+	double	pValue;
+	double	distance;
+	double	limit;
+	double	wordsPerSecond = sampleSpeed(candidate);
+	bool	fastEnough;
+	int	passed = 1;
+
+
+	cout << name << ": " << candidate.words << " words, " << fixed << setprecision(0) << wordsPerSecond << " words per second" << endl;
+
+	if ((reference.words == 0) || (candidate.words == 0))
+	{
+		cout << "  no words were generated  FAIL" << endl;
+		return 0;
+	}
+
+	pValue = chiSquareHomogeneity(&reference.positions[0][0], &candidate.positions[0][0], VERIFY_POSITIONS * LETTER_COUNT, statistic, degrees);
+	passed &= reportChiSquare("letter by position", pValue, statistic, degrees);
+
+	pValue = chiSquareHomogeneity(&reference.transitions[0][0], &candidate.transitions[0][0], LETTER_COUNT * LETTER_COUNT, statistic, degrees);
+	passed &= reportChiSquare("letter pairs", pValue, statistic, degrees);
+
+	pValue = chiSquareHomogeneity(reference.lengths, candidate.lengths, MAX_CHAR, statistic, degrees);
+	passed &= reportChiSquare("lengths", pValue, statistic, degrees);
+
+	if (kolmogorovSmirnov(reference, candidate, distance, limit))
+	{
+		cout << "  " << left << setw(22) << "lengths (KS)" << right << "D = " << setprecision(5) << distance << " <= " << limit << "  PASS" << endl;
+	}
+	else
+	{
+		cout << "  " << left << setw(22) << "lengths (KS)" << right << "D = " << setprecision(5) << distance << " > " << limit << "  FAIL" << endl;
+		passed = 0;
+	}
+
+	// No change may make a generator slower than its recorded baseline, or than the floor
+	fastEnough = (wordsPerSecond >= minimumSpeed);
+	cout << "  " << left << setw(22) << "throughput" << right << setprecision(0) << wordsPerSecond << " words/s, needs " << minimumSpeed;
+	cout << "  " << (fastEnough ? "PASS" : "FAIL") << endl;
+	if (!fastEnough)
+	{
+		passed = 0;
+	}
+
+	cout.unsetf(ios::floatfield);
+	cout << setprecision(6);
+
+	return passed;
+}
\ No newline at end of file
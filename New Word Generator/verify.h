@@ -0,0 +1,62 @@
+#pragma once
+#include "randomWord.h"
+#include "batchGenerator.h"
+#include <map>
+
+
+// VERIFY SETTINGS
+const int VERIFY_POSITIONS = 32;			// Letter positions compared (later letters are left out)
+const double VERIFY_ALPHA = 0.001;			// A test fails when its p-value is below this
+const double VERIFY_KS_COEFFICIENT = 1.949;		// c(alpha) of the two-sample Kolmogorov-Smirnov test at VERIFY_ALPHA
+const double VERIFY_SPEED_MARGIN = 0.9;			// A candidate may run at this share of its baseline speed before it counts as slower (timing noise)
+const double VERIFY_MIN_EXPECTED = 5;			// Cells expecting fewer words than this are pooled for chi-square
+const unsigned long long VERIFY_REFERENCE_SEED = 1;	// Fixed seeds, so a run always gives the same verdict
+const unsigned long long VERIFY_CANDIDATE_SEED = 2;
+const int VERIFY_BATCH_WORDS = 4096;			// Words per batch for the batched candidate
+
+
+// What a generator produced during verification
+struct VerifySample
+{
+	long long	positions[VERIFY_POSITIONS][LETTER_COUNT];	// Letters at each position
+	long long	transitions[LETTER_COUNT][LETTER_COUNT];	// Letter pairs, [letter][letter after it]
+	long long	lengths[MAX_CHAR];				// Words of each length
+	long long	words;						// Words generated
+	double		seconds;					// Time spent generating them
+};
+
+
+// Verify Utilities
+//
+// Checks that the optimized generators produce the same distribution as the reference algorithm
+// (RandomWord::setReferenceMode()), using the fixed seeds above, and that they are no slower than
+// a baseline recorded by an earlier run on the same machine.
+// Letter-by-position and letter-pair tables are compared with chi-square tests of homogeneity,
+// word lengths with a two-sample Kolmogorov-Smirnov test.
+//
+// Generates wordCount words with every generator borrowing corpusOwner's donor list and lengths (nullptr for the default)
+// A candidate also fails if it makes fewer than throughputFloor words per second (0 for no floor), or runs slower
+// than VERIFY_SPEED_MARGIN of its speed in baselineFile (empty for no baseline)
+// The speeds of this run are written to recordFile (empty to skip) for a later run to compare with
+// Displays every test and returns 0 if any failed, 1 if all passed
+int runVerify(const RandomWord& corpusOwner, const LengthDistribution* lengths, const long long& wordCount, const double& throughputFloor,
+	const string& baselineFile, const string& recordFile);
+//
+// Reads the words per second of each generator from fileName into speeds
+// Returns 0 for failure, 1 for success
+int readVerifyBaseline(const string& fileName, map<string, double>& speeds);
+//
+// Writes the words per second of each generator in speeds to fileName, one "name speed" line each
+// Returns 0 for failure, 1 for success
+int writeVerifyBaseline(const string& fileName, const map<string, double>& speeds);
+//
+// Empties sample
+void clearVerifySample(VerifySample& sample);
+//
+// Counts word into sample
+void addVerifyWord(VerifySample& sample, const char word[]);
+//
+// Compares candidate with reference and displays each test
+// The candidate fails if it makes fewer than minimumSpeed words per second (0 for no minimum)
+// Returns 0 if any test failed, 1 if all passed
+int compareVerifySamples(const VerifySample& reference, const VerifySample& candidate, const string& name, const double& minimumSpeed);
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "selfTest.h"
+#include "verify.h"
+#include <sstream>
+
+using namespace std;
+
+// VERIFY TEST SETTINGS
+const long long VERIFY_TEST_WORDS = 20000;	// Words each generator makes per verification
+
+
+
+// Runs runVerify() on VERIFY_TEST_WORDS words with its report captured
+// Returns what runVerify() returns
+static int captureVerify(const RandomWord& corpusOwner, const string& baselineFile, const string& recordFile)
+{
+	stringstream	report;
+	streambuf*	coutBuffer = cout.rdbuf(report.rdbuf());
+	streambuf*	cerrBuffer = cerr.rdbuf(report.rdbuf());
+	int		successValue;
+
+
+	successValue = runVerify(corpusOwner, nullptr, VERIFY_TEST_WORDS, 0, baselineFile, recordFile);
+	cout.rdbuf(coutBuffer);
+	cerr.rdbuf(cerrBuffer);
+
+	return successValue;
+}
+
+// Checks that the comparison catches a candidate whose letters drift from the reference
+static void testDrift(const RandomWord& corpusOwner)
+{
+	RandomWord	generator(&corpusOwner);
+	VerifySample	reference;
+	VerifySample	candidate;
+	char		driftWord[MAX_CHAR];
+	stringstream	report;
+	streambuf*	coutBuffer;
+	int		same;
+	int		drifted;
+	int		slow;
+	int		i;
+
+
+	clearVerifySample(reference);
+	clearVerifySample(candidate);
+	generator.seed(VERIFY_REFERENCE_SEED);
+	for (i = 0; i < VERIFY_TEST_WORDS; ++i)
+	{
+		generator.generate();
+		addVerifyWord(reference, generator.word());
+	}
+	generator.seed(VERIFY_CANDIDATE_SEED);
+	for (i = 0; i < VERIFY_TEST_WORDS; ++i)
+	{
+		generator.generate();
+		addVerifyWord(candidate, generator.word());
+	}
+
+	coutBuffer = cout.rdbuf(report.rdbuf());
+	same = compareVerifySamples(reference, candidate, "same", 0);
+
+	// Start one word in twenty with a z
+	clearVerifySample(candidate);
+	for (i = 0; i < VERIFY_TEST_WORDS; ++i)
+	{
+		generator.generate();
+		stringCopy(driftWord, MAX_CHAR, generator.word());
+		driftWord[0] = (i % 20 == 0) ? 'z' : driftWord[0];
+		addVerifyWord(candidate, driftWord);
+	}
+	drifted = compareVerifySamples(reference, candidate, "drifted", 0);
+	slow = compareVerifySamples(reference, reference, "slow", 1e15);
+	cout.rdbuf(coutBuffer);
+
+	selfCheck(same != 0, "two seeds of one generator pass the comparison");
+	selfCheck(drifted == 0, "a generator whose first letters drift fails the comparison");
+	selfCheck(slow == 0, "a generator slower than its minimum speed fails");
+}
+
+// Checks that a recorded baseline is compared with, and that an unreadable one fails the run
+static void testBaseline(const RandomWord& corpusOwner)
+{
+	string			fileName = selfTestPath("verify-baseline.txt");
+	map<string, double>	speeds;
+	ofstream		out;
+
+
+	selfCheck(captureVerify(corpusOwner, "", fileName) != 0, "the optimized and batched generators match the reference");
+	selfCheck((readVerifyBaseline(fileName, speeds) != 0) && (speeds.size() == 2) && (speeds["optimized"] > 0) && (speeds["batched"] > 0),
+		"a run records the speed of each generator");
+
+	speeds["optimized"] = 1;
+	speeds["batched"] = 1;
+	writeVerifyBaseline(fileName, speeds);
+	selfCheck(captureVerify(corpusOwner, fileName, "") != 0, "a run faster than its baseline passes");
+
+	speeds["batched"] = 1e15;
+	writeVerifyBaseline(fileName, speeds);
+	selfCheck(captureVerify(corpusOwner, fileName, "") == 0, "a run slower than its baseline fails");
+
+	out.open(fileName, ios::trunc);
+	out << "optimized fast\n";
+	out.close();
+	selfCheck(captureVerify(corpusOwner, fileName, "") == 0, "a malformed baseline fails the run");
+	remove(fileName.c_str());
+	selfCheck(captureVerify(corpusOwner, fileName, "") == 0, "a missing baseline fails the run");
+}
+
+
+
+// Distribution and throughput checks of --verify
+void testVerify()
+{
+	string	fileName = selfTestPath("verify.txt");
+
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the verify corpus"))
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		testDrift(aRandomWord);
+		testBaseline(aRandomWord);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "wordBatch.h"
+#include <functional>
+#include <vector>
+
+using namespace std;
+
+WordBatch::WordBatch(const int& capacity, const int& maxLength)
+{
+	_capacity = capacity;
+	_maxLength = min(maxLength, MAX_CHAR - 1);
+	_size = 0;
+
+	// The extra row means every word ends in '\0', however long it is
+	_letters = new char[(size_t)(_maxLength + 1) * _capacity];
+	_lengths = new unsigned char[_capacity];
+	_scores = new float[_capacity];
+
+	memset(_letters, 0, (size_t)(_maxLength + 1) * _capacity);
+	memset(_lengths, 0, _capacity);
+	memset(_scores, 0, _capacity * sizeof(float));
+}
+
+WordBatch::~WordBatch()
+{
+	delete[] _letters;
+	delete[] _lengths;
+	delete[] _scores;
+}
+
+
+
+// Adds a copy of word to the end of the batch
+// Returns 0 if the batch is full or the word is too long, 1 for success
+int WordBatch::add(const char word[])
+{
+	int	wordLength = strlen(word);
+	int	k;
+
+
+	if ((_size == _capacity) || (wordLength > _maxLength))
+	{
+		return 0;
+	}
+
+	for (k = 0; k < _maxLength; ++k)
+	{
+		_letters[(size_t)k * _capacity + _size] = (k < wordLength) ? word[k] : '\0';
+	}
+	_lengths[_size] = wordLength;
+	_scores[_size] = 0;
+	++_size;
+
+	return 1;
+}
+
+// Empties the batch
+void WordBatch::clear()
+{
+	_size = 0;
+}
+
+// Keeps only the highest scoring fraction of the words (at least 1 if there are any), in their original order
+// Returns the number of words kept
+int WordBatch::keepTop(const double& fraction)
+{
+	vector<float>	ranked(_scores, _scores + _size);
+	int		keepCount;
+	int		kept = 0;
+	int		tiesLeft;	// Words scoring exactly the threshold that may still be kept
+	float		threshold;
+	int		i;
+
+
+	if (_size == 0)
+	{
+		return 0;
+	}
+
+	keepCount = max(1, min(_size, (int)(_size * fraction + 0.5)));
+
+	// The keepCount-th highest score is the lowest one kept
+	nth_element(ranked.begin(), ranked.begin() + (keepCount - 1), ranked.end(), greater<float>());
+	threshold = ranked[keepCount - 1];
+	tiesLeft = keepCount - (int)count_if(ranked.begin(), ranked.end(), [threshold](const float& score) { return score > threshold; });
+
+	for (i = 0; i < _size; ++i)
+	{
+		if ((_scores[i] > threshold) || ((_scores[i] == threshold) && (tiesLeft-- > 0)))
+		{
+			moveWord(i, kept++);
+		}
+	}
+	_size = kept;
+
+	return kept;
+}
+
+// Keeps only the words whose keep entry is not 0, in their original order
+// Returns the number of words kept
+int WordBatch::keepWhere(const unsigned char keep[])
+{
+	int	kept = 0;
+	int	i;
+
+
+	for (i = 0; i < _size; ++i)
+	{
+		if (keep[i] != 0)
+		{
+			moveWord(i, kept++);
+		}
+	}
+	_size = kept;
+
+	return kept;
+}
+
+// Marks the first size words as filled in, for writers that fill letters() and lengths() directly
+// Returns 0 if size is above capacity(), 1 for success
+int WordBatch::setSize(const int& size)
+{
+	int	i;
+
+
+	if ((size < 0) || (size > _capacity))
+	{
+		return 0;
+	}
+
+	_size = size;
+	for (i = 0; i < _size; ++i)
+	{
+		_scores[i] = 0;
+	}
+
+	return 1;
+}
+
+
+
+// Copies word wordIndex into buffer, which must hold maxLength() + 1 chars
+void WordBatch::copyWord(const int& wordIndex, char buffer[]) const
+{
+	int	k;
+
+	for (k = 0; k <= _lengths[wordIndex]; ++k)
+	{
+		buffer[k] = _letters[(size_t)k * _capacity + wordIndex];
+	}
+}
+
+// Returns the number of words in the batch
+int WordBatch::size() const
+{
+	return _size;
+}
+
+// Returns the most words the batch can hold
+int WordBatch::capacity() const
+{
+	return _capacity;
+}
+
+// Returns the most letters a word in the batch can have
+int WordBatch::maxLength() const
+{
+	return _maxLength;
+}
+
+// Returns the letters at position (letter k of every word, '\0' past the end of a word)
+char* WordBatch::letters(const int& position)
+{
+	return _letters + (size_t)position * _capacity;
+}
+
+const char* WordBatch::letters(const int& position) const
+{
+	return _letters + (size_t)position * _capacity;
+}
+
+// Returns the length of every word
+unsigned char* WordBatch::lengths()
+{
+	return _lengths;
+}
+
+const unsigned char* WordBatch::lengths() const
+{
+	return _lengths;
+}
+
+// Returns the score of every word
+float* WordBatch::scores()
+{
+	return _scores;
+}
+
+const float* WordBatch::scores() const
+{
+	return _scores;
+}
+
+
+
+// Moves word from into the place of word to
+void WordBatch::moveWord(const int& from, const int& to)
+{
+	int	k;
+
+	if (from != to)
+	{
+		for (k = 0; k < _maxLength; ++k)
+		{
+			_letters[(size_t)k * _capacity + to] = _letters[(size_t)k * _capacity + from];
+		}
+		_lengths[to] = _lengths[from];
+		_scores[to] = _scores[from];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include "utilities.h"
+
+
+// A batch of words stored as a structure of arrays
+//
+// Letters are stored position-major: letter k of every word sits next to letter k of the
+// word before it, so a pass over one letter position of the whole batch reads one
+// contiguous run of memory. Lengths and scores are kept in their own arrays.
+class WordBatch
+{
+public:
+	// Constructor
+	// Holds up to capacity words of up to maxLength letters each
+	WordBatch(const int& capacity, const int& maxLength);
+	//
+	// The letter, length, and score arrays are freed by the destructor, so a batch can't be copied
+	WordBatch(const WordBatch&) = delete;
+	WordBatch& operator=(const WordBatch&) = delete;
+	//
+	// Destructor
+	~WordBatch();
+
+	// Adds a copy of word to the end of the batch
+	// Returns 0 if the batch is full or the word is too long, 1 for success
+	int add(const char word[]);
+	//
+	// Empties the batch
+	void clear();
+	//
+	// Keeps only the highest scoring fraction of the words (at least 1 if there are any), in their original order
+	// Returns the number of words kept
+	int keepTop(const double& fraction);
+	//
+	// Keeps only the words whose keep entry is not 0, in their original order
+	// Returns the number of words kept
+	int keepWhere(const unsigned char keep[]);
+	//
+	// Marks the first size words as filled in, for writers that fill letters() and lengths() directly
+	// (every letter past a word's length, up to maxLength(), must be '\0')
+	// Returns 0 if size is above capacity(), 1 for success
+	int setSize(const int& size);
+
+	// Copies word wordIndex into buffer, which must hold maxLength() + 1 chars
+	void copyWord(const int& wordIndex, char buffer[]) const;
+
+	// Returns the number of words in the batch
+	int size() const;
+	//
+	// Returns the most words the batch can hold
+	int capacity() const;
+	//
+	// Returns the most letters a word in the batch can have
+	int maxLength() const;
+	//
+	// Returns the letters at position (letter k of every word, '\0' past the end of a word)
+	char* letters(const int& position);
+	const char* letters(const int& position) const;
+	//
+	// Returns the length of every word
+	unsigned char* lengths();
+	const unsigned char* lengths() const;
+	//
+	// Returns the score of every word
+	float* scores();
+	const float* scores() const;
+
+private:
+	int		_capacity;	// Most words the batch can hold
+	int		_maxLength;	// Most letters a word can have
+	int		_size;		// Words in the batch
+	char*		_letters;	// Letter k of word w is _letters[k * _capacity + w], with one extra row of '\0'
+	unsigned char*	_lengths;	// Length of each word
+	float*		_scores;	// Score of each word, filled in by whoever scores the batch
+
+
+
+	// Moves word from into the place of word to
+	void moveWord(const int& from, const int& to);
+};
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "wordLength.h"
+#include "randomWord.h"
+#include <cstdio>
+
+using namespace std;
+
+LengthDistribution::LengthDistribution()
+{
+	int	i;
+
+
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		_weights[i] = 0;
+		_bounds[i] = 0;
+	}
+	_smallest = 0;
+	_largest = 0;
+}
+
+
+
+// Gives every length from smallest to largest (inclusive) the same weight
+// Returns 0 if the bounds are outside SMALLEST_WORD to LONGEST_LENGTH or reversed, 1 for success
+int LengthDistribution::setUniform(const int& smallest, const int& largest)
+{
+	int	i;
+
+
+	if ((smallest < SMALLEST_WORD) || (largest > LONGEST_LENGTH) || (smallest > largest))
+	{
+		return 0;
+	}
+
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		_weights[i] = ((i >= smallest) && (i <= largest)) ? 1 : 0;
+	}
+
+	return build();
+}
+
+// Weights every length by how many donor words of corpus have it (lengths below SMALLEST_WORD are left out)
+// Returns 0 if corpus has no donor word long enough, 1 for success
+int LengthDistribution::setEmpirical(const RandomWord& corpus)
+{
+	int	length;
+	int	i;
+
+
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		_weights[i] = 0;
+	}
+
+	for (i = 0; i < corpus.listSize(); ++i)
+	{
+		length = corpus.donorLength(i);
+		if (length >= SMALLEST_WORD)
+		{
+			_weights[min(length, LONGEST_LENGTH)] += 1;
+		}
+	}
+
+	return build();
+}
+
+// Reads a table of "length weight" lines from fileName (blank lines and lines starting with # are skipped)
+// Returns 0 if the file can't open or has no usable line, 1 for success
+int LengthDistribution::load(const string& fileName)
+{
+	ifstream	in;
+	char		bufferLine[MAX_CHAR];
+	int		length;
+	double		weight;
+	int		i;
+
+
+	in.open(fileName);
+	if (!in)
+	{
+		cerr << "Cannot read from " << fileName << endl;
+		return 0;
+	}
+
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		_weights[i] = 0;
+	}
+
+	while (readLine(in, bufferLine))
+	{
+		if ((bufferLine[0] == '\0') || (bufferLine[0] == '#'))
+		{
+			continue;
+		}
+
+		if ((sscanf(bufferLine, "%d %lf", &length, &weight) == 2) &&
+			(length >= SMALLEST_WORD) && (length <= LONGEST_LENGTH) && (weight > 0))
+		{
+			_weights[length] += weight;
+		}
+		else
+		{
+			cerr << "Skipping \"" << bufferLine << "\" in " << fileName << endl;
+		}
+	}
+	in.close();
+
+	return build();
+}
+
+
+
+// Returns a length drawn with randomBits, a uniform 32-bit random number
+int LengthDistribution::sample(const unsigned int& randomBits) const
+{
+	// The first bound above the draw; lengths with no weight share the bound before them, so are never picked
+	return (int)(upper_bound(_bounds + _smallest, _bounds + _largest, (unsigned long long)randomBits) - _bounds);
+}
+
+// Returns the shortest length with any weight (0 when empty)
+int LengthDistribution::smallest() const
+{
+	return _smallest;
+}
+
+// Returns the longest length with any weight (0 when empty)
+int LengthDistribution::largest() const
+{
+	return _largest;
+}
+
+// Check if no length has any weight yet
+// Returns true if sample() can't be used
+bool LengthDistribution::empty() const
+{
+	return (_largest == 0);
+}
+
+
+
+// Turns _weights into _bounds, _smallest and _largest
+// Returns 0 if no length has any weight, 1 for success
+int LengthDistribution::build()
+{
+	double	totalWeight = 0;
+	double	runningWeight = 0;
+	int	i;
+
+
+	_smallest = 0;
+	_largest = 0;
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		if (_weights[i] > 0)
+		{
+			if (_smallest == 0)
+			{
+				_smallest = i;
+			}
+			_largest = i;
+			totalWeight += _weights[i];
+		}
+	}
+
+	if (_largest == 0)
+	{
+		return 0;
+	}
+
+	// Split the 2^32 possible draws between the lengths in proportion to their weights
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		runningWeight += _weights[i];
+		_bounds[i] = (unsigned long long)(runningWeight / totalWeight * 4294967296.0);
+	}
+	// Rounding must never leave a draw without a length
+	_bounds[_largest] = 4294967296ULL;
+
+	return 1;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include "utilities.h"
+
+class RandomWord;
+
+
+// LENGTH DISTRIBUTION SETTINGS
+const int LONGEST_LENGTH = MAX_CHAR - 1;	// Longest word any distribution can produce (the buffers hold MAX_CHAR chars)
+
+
+// Chooses the length of each generated word
+//
+// Every length from smallest() to largest() has a weight, and a 32-bit random number is turned into
+// a length with one binary search over the running totals, so the cost is the same for every shape.
+// sample() takes its random bits from the caller and changes nothing, so generators on any number of
+// threads can draw from one distribution.
+class LengthDistribution
+{
+public:
+	// Constructor
+	// Starts with no lengths, see empty()
+	LengthDistribution();
+
+	// Gives every length from smallest to largest (inclusive) the same weight
+	// Returns 0 if the bounds are outside SMALLEST_WORD to LONGEST_LENGTH or reversed, 1 for success
+	int setUniform(const int& smallest, const int& largest);
+	//
+	// Weights every length by how many donor words of corpus have it (lengths below SMALLEST_WORD are left out)
+	// Returns 0 if corpus has no donor word long enough, 1 for success
+	int setEmpirical(const RandomWord& corpus);
+	//
+	// Reads a table of "length weight" lines from fileName (blank lines and lines starting with # are skipped)
+	// Returns 0 if the file can't open or has no usable line, 1 for success
+	int load(const string& fileName);
+
+	// Returns a length drawn with randomBits, a uniform 32-bit random number
+	int sample(const unsigned int& randomBits) const;
+
+	// Returns the shortest length with any weight (0 when empty)
+	int smallest() const;
+	//
+	// Returns the longest length with any weight (0 when empty)
+	int largest() const;
+	//
+	// Check if no length has any weight yet
+	// Returns true if sample() can't be used
+	bool empty() const;
+
+private:
+	double			_weights[MAX_CHAR];	// Weight of each length (0 for lengths never drawn)
+	unsigned long long	_bounds[MAX_CHAR];	// A draw below _bounds[length] (and not below the previous bound) gives that length
+	int			_smallest;		// Shortest length with any weight
+	int			_largest;		// Longest length with any weight
+
+
+
+	// Turns _weights into _bounds, _smallest and _largest
+	// Returns 0 if no length has any weight, 1 for success
+	int build();
+};
\ No newline at end of file
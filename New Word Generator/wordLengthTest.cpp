@@ -0,0 +1,107 @@
+#include "selfTest.h"
+#include "randomWord.h"
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+// Draws sample() at drawCount evenly spaced points of the 32-bit range
+// Returns how many draws gave each length
+static vector<int> countDraws(const LengthDistribution& lengths, const int& drawCount)
+{
+	vector<int>	draws(MAX_CHAR, 0);
+	int		i;
+
+
+	for (i = 0; i < drawCount; ++i)
+	{
+		++draws[lengths.sample((unsigned int)(((unsigned long long)i << 32) / drawCount))];
+	}
+
+	return draws;
+}
+
+// Checks the bounds setUniform() accepts and that every length it allows is drawn equally often
+static void testUniform()
+{
+	LengthDistribution	lengths;
+	vector<int>		draws;
+
+
+	selfCheck((lengths.empty()) && (lengths.setUniform(SMALLEST_WORD - 1, 5) == 0) && (lengths.setUniform(6, 5) == 0) &&
+		(lengths.setUniform(3, LONGEST_LENGTH + 1) == 0), "setUniform() refuses bounds outside SMALLEST_WORD to LONGEST_LENGTH");
+
+	lengths.setUniform(3, 5);
+	draws = countDraws(lengths, 3000);
+	selfCheck((draws[3] == 1000) && (draws[4] == 1000) && (draws[5] == 1000), "a uniform distribution draws every length equally often");
+	selfCheck((lengths.sample(0) == 3) && (lengths.sample(0xFFFFFFFFu) == 5), "the lowest and highest draws give the shortest and longest lengths");
+}
+
+// Checks a weight table with comments, empty lines, and a bad line
+static void testLoad()
+{
+	string			fileName = selfTestPath("lengths.txt");
+	ofstream		out(fileName);
+	LengthDistribution	lengths;
+	vector<int>		draws;
+	int			loaded;
+
+
+	out << "# length weight\n3 1\n\n5 3\nbad line\n\n";
+	out.close();
+	{
+		stringstream	errors;
+		streambuf*	cerrBuffer = cerr.rdbuf(errors.rdbuf());
+
+		loaded = lengths.load(fileName);
+		cerr.rdbuf(cerrBuffer);
+	}
+	remove(fileName.c_str());
+
+	draws = countDraws(lengths, 4000);
+	selfCheck((loaded == 1) && (draws[3] == 1000) && (draws[4] == 0) && (draws[5] == 3000), "a loaded table draws each length in proportion to its weight");
+}
+
+// Checks the lengths taken from a corpus, and that a generator only makes words of the lengths allowed
+static void testGeneratedLengths(RandomWord& aRandomWord)
+{
+	LengthDistribution	lengths;
+	bool			allowed = true;
+	int			i;
+
+
+	// The test corpus holds words of 3 to 12 letters
+	selfCheck((lengths.setEmpirical(aRandomWord) == 1) && (lengths.smallest() == 3) && (lengths.largest() == 12),
+		"the corpus lengths run from its shortest to its longest donor word");
+
+	lengths.setUniform(7, 8);
+	aRandomWord.setLengthDistribution(&lengths);
+	for (i = 0; i < 500; ++i)
+	{
+		aRandomWord.generate();
+		allowed &= (strlen(aRandomWord.word()) == 7) || (strlen(aRandomWord.word()) == 8);
+	}
+	aRandomWord.setLengthDistribution(nullptr);
+
+	selfCheck(allowed, "a generator only makes words of the lengths its distribution allows");
+}
+
+
+
+// LengthDistribution shapes, tables, and use by RandomWord
+void testWordLength()
+{
+	string	fileName = selfTestPath("length-corpus.txt");
+
+
+	testUniform();
+	testLoad();
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the length corpus"))
+	{
+		RandomWord	aRandomWord(fileName, 0);
+
+		testGeneratedLengths(aRandomWord);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
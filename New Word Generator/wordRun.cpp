@@ -0,0 +1,303 @@
+#include "wordRun.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Set by SIGUSR1 to ask for the statistics so far
+static volatile sig_atomic_t	reportRequested = 0;
+
+// One generator thread and everything it has counted
+struct RunWorker
+{
+	thread		worker;		// The thread itself
+	mutex		statsLock;	// Held while the thread adds to stats, so a report can read them
+	WordStats	stats;		// Statistics for this thread's words
+	long long	wordCount;	// Words this thread is to generate
+	long long	wordsLeft;	// Words it has yet to generate (above 0 after it finishes only if it gave up)
+};
+
+// Asks the reporting loop for the statistics so far
+static void requestReport(int)
+{
+	reportRequested = 1;
+}
+
+// Drops the words of batch already in unique, keeping at most wordsLeft new ones (keep must hold batch.size() entries)
+// Returns 0 if unique can take no more words, 1 for success
+static int keepNewWords(UniqueWordSet& unique, WordBatch& batch, const long long& wordsLeft, unsigned char keep[])
+{
+	char		bufferWord[MAX_CHAR];
+	long long	kept = 0;
+	int		inserted;
+	int		i;
+
+
+	for (i = 0; i < batch.size(); ++i)
+	{
+		keep[i] = 0;
+
+		// Words past wordsLeft are never written, so they must not be marked as made
+		if (kept < wordsLeft)
+		{
+			batch.copyWord(i, bufferWord);
+			inserted = unique.insert(bufferWord);
+			if (inserted < 0)
+			{
+				return 0;
+			}
+			keep[i] = (unsigned char)inserted;
+			kept += inserted;
+		}
+	}
+
+	batch.keepWhere(keep);
+
+	return 1;
+}
+
+// Generates worker->wordCount words and writes them to cout in chunks
+static void runWorker(const RandomWord* corpusOwner, const Blocklist* blocklist, const RunSettings* settings,
+	RunWorker* worker, mutex* outputLock, atomic<int>* finishedWorkers)
+{
+	RandomWord	aRandomWord(corpusOwner);
+	unique_ptr<BatchGenerator>	batchGenerator;	// Only built for a batched run, its alias tables are not small
+	ThreadMetrics*	metrics = (settings->metrics != nullptr) ? settings->metrics->addThread() : nullptr;
+	WordBatch	batch(RUN_CHUNK_WORDS, (settings->lengths != nullptr) ? settings->lengths->largest() : LARGEST_WORD);
+	char		bufferWord[MAX_CHAR];
+	string		output;		// Words waiting to be written
+	vector<unsigned char>	keep(RUN_CHUNK_WORDS);	// Scratch for keepNewWords()
+	long long	wordsLeft = worker->wordCount;
+	int		staleBatches = 0;	// Batches in a row that held no new word
+	int		candidates;	// Words to generate for this batch
+	int		emitted;	// Words of this batch that count towards wordsLeft
+	long long	emittedLetters;	// Letters of those words
+	int		i;
+
+
+	aRandomWord.setBlocklist(blocklist);
+	aRandomWord.setLengthDistribution(settings->lengths);
+	aRandomWord.setMetrics(metrics);
+	if (settings->batched)
+	{
+		batchGenerator.reset(new BatchGenerator(aRandomWord));
+		batchGenerator->setBlocklist(blocklist);
+		batchGenerator->setLengthDistribution(settings->lengths);
+		batchGenerator->setMetrics(metrics);
+	}
+
+	while (wordsLeft > 0)
+	{
+		// When scoring, always fill the batch since only part of it is kept
+		candidates = (settings->scorer != nullptr) ? RUN_CHUNK_WORDS : (int)min(wordsLeft, (long long)RUN_CHUNK_WORDS);
+
+		if (settings->batched)
+		{
+			batchGenerator->generate(batch, candidates);
+		}
+		else
+		{
+			batch.clear();
+			for (i = 0; i < candidates; ++i)
+			{
+				if (aRandomWord.generate(settings->workBudget) != 0)
+				{
+					batch.add(aRandomWord.word());
+				}
+			}
+		}
+
+		// Every candidate was blocked, so no batch will ever fill (runWords() reports the words missing)
+		if (batch.size() == 0)
+		{
+			break;
+		}
+
+		if (settings->scorer != nullptr)
+		{
+			settings->scorer->scoreBatch(batch);
+			batch.keepTop(settings->keepFraction);
+		}
+
+		// Duplicates are dropped and the words they leave missing come from the next batch
+		if (settings->unique != nullptr)
+		{
+			if (keepNewWords(*settings->unique, batch, wordsLeft, keep.data()) == 0)
+			{
+				break;
+			}
+			if (batch.size() == 0)
+			{
+				if (++staleBatches >= RUN_STALE_BATCHES)
+				{
+					break;
+				}
+				continue;
+			}
+			staleBatches = 0;
+		}
+
+		emitted = (int)min(wordsLeft, (long long)batch.size());
+		wordsLeft -= emitted;
+
+		{
+			lock_guard<mutex>	hold(worker->statsLock);
+
+			for (i = 0; i < emitted; ++i)
+			{
+				batch.copyWord(i, bufferWord);
+				if (settings->printWords)
+				{
+					output += bufferWord;
+					output += '\n';
+				}
+				if (settings->collectStats)
+				{
+					worker->stats.addWord(bufferWord, aRandomWord.isDonorWord(bufferWord));
+				}
+			}
+		}
+
+		if (metrics != nullptr)
+		{
+			emittedLetters = 0;
+			for (i = 0; i < emitted; ++i)
+			{
+				emittedLetters += batch.lengths()[i];
+			}
+			addMetric(metrics->words, emitted);
+			addMetric(metrics->letters, emittedLetters);
+		}
+
+		// Write the whole chunk at once so threads never interleave inside a line
+		if (!output.empty())
+		{
+			if (settings->metrics != nullptr)
+			{
+				settings->metrics->changeQueueDepth(1);
+			}
+
+			lock_guard<mutex>	hold(*outputLock);
+			cout.write(output.data(), output.size());
+			output.clear();
+
+			if (settings->metrics != nullptr)
+			{
+				settings->metrics->changeQueueDepth(-1);
+			}
+		}
+	}
+
+	worker->wordsLeft = wordsLeft;
+	++(*finishedWorkers);
+}
+
+// Merges every thread's statistics and displays them to cerr
+static void displayRunStats(vector<RunWorker>& workers)
+{
+	WordStats	total;
+	size_t		i;
+
+
+	for (i = 0; i < workers.size(); ++i)
+	{
+		lock_guard<mutex>	hold(workers[i].statsLock);
+		total.merge(workers[i].stats);
+	}
+
+	cerr << endl << "Word statistics" << endl;
+	total.display(cerr);
+}
+
+
+
+// Generates settings.wordCount words split across settings.threadCount threads
+// Every thread's RandomWord borrows corpusOwner's donor list and screens against blocklist (nullptr for none)
+// Returns 0 for failure (including a run that made fewer words than asked for), 1 for success
+int runWords(const RandomWord& corpusOwner, const Blocklist* blocklist, const RunSettings& settings)
+{
+	int			threads = max(1, settings.threadCount);
+	vector<RunWorker>	workers(threads);
+	mutex			outputLock;
+	atomic<int>		finishedWorkers(0);
+	long long		wordsMissing = 0;	// Words threads gave up on
+	void			(*previousHandler)(int) = SIG_DFL;	// What SIGUSR1 did before the run, put back after it
+	chrono::steady_clock::time_point	lastMetrics = chrono::steady_clock::now();	// When the metrics file was last written
+	int			i;
+
+
+#ifdef SIGUSR1
+	if (settings.collectStats)
+	{
+		previousHandler = signal(SIGUSR1, requestReport);
+	}
+#endif
+
+	for (i = 0; i < threads; ++i)
+	{
+		workers[i].wordCount = (settings.wordCount * (i + 1) / threads) - (settings.wordCount * i / threads);
+		workers[i].worker = thread(runWorker, &corpusOwner, blocklist, &settings, &workers[i], &outputLock, &finishedWorkers);
+	}
+
+	// Wait for the threads, showing the statistics so far whenever they are asked for
+	// and rewriting the metrics file every METRICS_INTERVAL_MS
+	while (finishedWorkers < threads)
+	{
+		this_thread::sleep_for(chrono::milliseconds(50));
+		if ((reportRequested) && (settings.collectStats))
+		{
+			reportRequested = 0;
+			displayRunStats(workers);
+		}
+		if ((settings.metrics != nullptr) && (chrono::steady_clock::now() - lastMetrics >= chrono::milliseconds(METRICS_INTERVAL_MS)))
+		{
+			settings.metrics->writeFile();
+			lastMetrics = chrono::steady_clock::now();
+		}
+	}
+
+	for (i = 0; i < threads; ++i)
+	{
+		workers[i].worker.join();
+		wordsMissing += workers[i].wordsLeft;
+	}
+	cout.flush();
+
+#ifdef SIGUSR1
+	if (settings.collectStats)
+	{
+		signal(SIGUSR1, previousHandler);
+		reportRequested = 0;
+	}
+#endif
+
+	// One last time, so the file ends with the whole run
+	if (settings.metrics != nullptr)
+	{
+		settings.metrics->writeFile();
+	}
+
+	if (settings.collectStats)
+	{
+		displayRunStats(workers);
+		if (settings.unique != nullptr)
+		{
+			settings.unique->display(cerr);
+		}
+	}
+
+	// A thread gives up once every candidate is blocked, or a unique run stops finding new words
+	if (wordsMissing > 0)
+	{
+		cerr << "Error! Only " << (settings.wordCount - wordsMissing) << " of " << settings.wordCount
+			<< ((settings.unique != nullptr) ? " unique" : "") << " words could be made" << endl;
+		return 0;
+	}
+
+	return 1;
+}
\ No newline at end of file
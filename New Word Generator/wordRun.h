@@ -0,0 +1,35 @@
+#pragma once
+#include "randomWord.h"
+#include "batchGenerator.h"
+#include "uniqueWords.h"
+#include "wordStats.h"
+#include "pronounce.h"
+
+
+// RUN SETTINGS
+const int RUN_CHUNK_WORDS = 4096;	// Words a thread generates (and scores) as one batch between flushing its output
+const int RUN_STALE_BATCHES = 16;	// Batches in a row without a new word before a unique run gives up
+
+
+// What runWords() should do
+// Every field starts at the value that leaves its feature off, so a caller only sets the ones it uses
+struct RunSettings
+{
+	long long	wordCount = 0;		// Words to generate across every thread
+	int		threadCount = 1;	// Generator threads, each with its own RandomWord sharing one donor list
+	int		workBudget = 0;		// Most donor words examined per word (0 for no limit)
+	bool		printWords = true;	// Write each word to cout on its own line
+	bool		collectStats = false;	// Keep WordStats, displayed to cerr at the end and whenever SIGUSR1 arrives
+	const PronounceScorer*	scorer = nullptr;	// Scores every batch so only the most pronounceable words are kept (nullptr keeps every word)
+	double		keepFraction = 1.0;	// Share of each batch kept when scorer is set
+	const LengthDistribution*	lengths = nullptr;	// Where each word's length is drawn from (nullptr for SMALLEST_WORD to LARGEST_WORD)
+	bool		batched = false;	// Fill each batch with a BatchGenerator instead of one RandomWord::generate() at a time
+	UniqueWordSet*	unique = nullptr;	// Replaces words already made, so every word of the run is different (nullptr allows repeats)
+	RunMetrics*	metrics = nullptr;	// Counts the run as it goes and rewrites its file every METRICS_INTERVAL_MS (nullptr for none)
+};
+
+
+// Generates settings.wordCount words split across settings.threadCount threads
+// Every thread's RandomWord borrows corpusOwner's donor list and screens against blocklist (nullptr for none)
+// Returns 0 for failure (including a run that made fewer words than asked for), 1 for success
+int runWords(const RandomWord& corpusOwner, const Blocklist* blocklist, const RunSettings& settings);
\ No newline at end of file
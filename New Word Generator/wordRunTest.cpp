@@ -0,0 +1,122 @@
+#include "selfTest.h"
+#include "wordRun.h"
+#include <csignal>
+#include <sstream>
+
+using namespace std;
+
+// Returns settings for a run of wordCount words on threadCount threads that only prints them
+static RunSettings testSettings(const long long& wordCount, const int& threadCount)
+{
+	RunSettings	settings;
+
+
+	settings.wordCount = wordCount;
+	settings.threadCount = threadCount;
+
+	return settings;
+}
+
+// Runs runWords() with cout and cerr captured, setting words to the number of lines written to cout
+// Returns what runWords() returns
+static int captureRun(const RandomWord& corpusOwner, const Blocklist* blocklist, const RunSettings& settings, long long& words)
+{
+	stringstream	output;
+	stringstream	errors;
+	streambuf*	coutBuffer = cout.rdbuf(output.rdbuf());
+	streambuf*	cerrBuffer = cerr.rdbuf(errors.rdbuf());
+	string		line;
+	int		successValue;
+
+
+	successValue = runWords(corpusOwner, blocklist, settings);
+	cout.rdbuf(coutBuffer);
+	cerr.rdbuf(cerrBuffer);
+
+	words = 0;
+	while (getline(output, line))
+	{
+		words += !line.empty();
+	}
+
+	return successValue;
+}
+
+#ifdef SIGUSR1
+// Stands in for whatever SIGUSR1 did before a run
+static void testHandler(int)
+{
+}
+#endif
+
+// Checks that a run makes exactly the words asked for, one RandomWord at a time or in batches
+static void testWordCounts(const RandomWord& corpusOwner)
+{
+	RunSettings	settings = testSettings(10001, 3);
+	long long	words;
+
+
+	selfCheck((captureRun(corpusOwner, nullptr, settings, words) == 1) && (words == 10001), "a run on 3 threads makes every word asked for");
+
+	settings.batched = true;
+	selfCheck((captureRun(corpusOwner, nullptr, settings, words) == 1) && (words == 10001), "a batched run makes every word asked for");
+}
+
+// Checks that a run which can't make every word says so, with or without --unique
+static void testShortfall(const RandomWord& corpusOwner)
+{
+	Blocklist	blocklist;
+	RunSettings	settings = testSettings(100, 2);
+	long long	words;
+	char		pattern[2] = { 'a', '\0' };
+
+
+	// Every letter is blocked, so every candidate is
+	for (pattern[0] = 'a'; pattern[0] <= 'z'; ++pattern[0])
+	{
+		blocklist.addPattern(pattern);
+	}
+	blocklist.compile();
+
+	selfCheck((captureRun(corpusOwner, &blocklist, settings, words) == 0) && (words == 0), "a run that can't make its words fails");
+
+	settings.batched = true;
+	selfCheck(captureRun(corpusOwner, &blocklist, settings, words) == 0, "a batched run that can't make its words fails");
+}
+
+// Checks that a run with statistics puts back the SIGUSR1 handler it replaced
+static void testSignalHandler(const RandomWord& corpusOwner)
+{
+#ifdef SIGUSR1
+	RunSettings	settings = testSettings(100, 1);
+	long long	words;
+	void		(*afterRun)(int);
+
+
+	settings.collectStats = true;
+	signal(SIGUSR1, testHandler);
+	captureRun(corpusOwner, nullptr, settings, words);
+	afterRun = signal(SIGUSR1, SIG_DFL);
+
+	selfCheck(afterRun == testHandler, "a run puts back the SIGUSR1 handler it replaced");
+#endif
+}
+
+
+
+// runWords() word counts, shortfalls, and signal handling
+void testWordRun()
+{
+	string	fileName = selfTestPath("run.txt");
+
+
+	if (selfCheck(writeTestCorpus(fileName, SELF_TEST_WORDS, SELF_TEST_SEED) != 0, "write the run corpus"))
+	{
+		RandomWord	corpusOwner(fileName, 0);
+
+		testWordCounts(corpusOwner);
+		testShortfall(corpusOwner);
+		testSignalHandler(corpusOwner);
+	}
+	remove(fileName.c_str());
+}
\ No newline at end of file
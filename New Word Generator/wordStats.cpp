@@ -0,0 +1,259 @@
+#include "wordStats.h"
+#include <cmath>
+
+using namespace std;
+
+WordStats::WordStats()
+{
+	_words = 0;
+	_corpusWords = 0;
+	_topCount = 0;
+	memset(_lengths, 0, sizeof(_lengths));
+	memset(_letters, 0, sizeof(_letters));
+	memset(_registers, 0, sizeof(_registers));
+	memset(_counters, 0, sizeof(_counters));
+}
+
+
+
+// Counts one generated word
+// inCorpus is true if the word is also a donor word
+void WordStats::addWord(const char word[], const bool& inCorpus)
+{
+	unsigned long long	hash = hashWord(word);
+	unsigned long long	rest;		// Hash bits left after the register index
+	unsigned char		rank;		// Position of the first 1 bit in rest
+	unsigned int		count;
+	int			row;
+	int			i;
+
+
+	++_words;
+	if (inCorpus)
+	{
+		++_corpusWords;
+	}
+
+	for (i = 0; word[i] != '\0'; ++i)
+	{
+		++_letters[letterIndex(word[i])];
+	}
+	++_lengths[min(i, MAX_CHAR - 1)];
+
+	// HyperLogLog: the top bits pick a register, which keeps the longest run of leading 0s seen
+	rest = (hash << STATS_HLL_BITS) | (1ULL << (STATS_HLL_BITS - 1));
+	rank = 1;
+	while ((rest & (1ULL << 63)) == 0)
+	{
+		++rank;
+		rest <<= 1;
+	}
+	_registers[hash >> (64 - STATS_HLL_BITS)] = max(_registers[hash >> (64 - STATS_HLL_BITS)], rank);
+
+	// Count-min: one counter per row, each row indexed by a different 16 bits of the hash
+	count = 0xFFFFFFFFu;
+	for (row = 0; row < STATS_CM_DEPTH; ++row)
+	{
+		unsigned int& counter = _counters[row][(hash >> (row * 16)) % STATS_CM_WIDTH];
+		++counter;
+		count = min(count, counter);
+	}
+
+	updateTopWords(word, count);
+}
+
+// Adds everything other has counted into this WordStats
+void WordStats::merge(const WordStats& other)
+{
+	int	row;
+	int	i;
+
+
+	_words += other._words;
+	_corpusWords += other._corpusWords;
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		_lengths[i] += other._lengths[i];
+	}
+	for (i = 0; i < STATS_LETTERS; ++i)
+	{
+		_letters[i] += other._letters[i];
+	}
+	for (i = 0; i < STATS_HLL_REGISTERS; ++i)
+	{
+		_registers[i] = max(_registers[i], other._registers[i]);
+	}
+	for (row = 0; row < STATS_CM_DEPTH; ++row)
+	{
+		for (i = 0; i < STATS_CM_WIDTH; ++i)
+		{
+			_counters[row][i] += other._counters[row][i];
+		}
+	}
+
+	// Re-estimate every candidate against the merged counters
+	for (i = 0; i < _topCount; ++i)
+	{
+		_topWords[i].count = estimate(hashWord(_topWords[i].word));
+	}
+	sort(_topWords, _topWords + _topCount, [](const TopWord& word1, const TopWord& word2) { return word1.count > word2.count; });
+	for (i = 0; i < other._topCount; ++i)
+	{
+		updateTopWords(other._topWords[i].word, estimate(hashWord(other._topWords[i].word)));
+	}
+}
+
+
+
+// Returns the number of words counted
+long long WordStats::words() const
+{
+	return _words;
+}
+
+// Returns the estimated number of distinct words counted
+double WordStats::distinctWords() const
+{
+	const double	registers = STATS_HLL_REGISTERS;
+	double		sum = 0;
+	int		emptyRegisters = 0;
+	double		estimate;
+	int		i;
+
+
+	for (i = 0; i < STATS_HLL_REGISTERS; ++i)
+	{
+		sum += ldexp(1.0, -_registers[i]);
+		if (_registers[i] == 0)
+		{
+			++emptyRegisters;
+		}
+	}
+
+	estimate = (0.7213 / (1 + 1.079 / registers)) * registers * registers / sum;
+
+	// Small counts are more accurate from the number of empty registers (linear counting)
+	if ((estimate <= 2.5 * registers) && (emptyRegisters > 0))
+	{
+		estimate = registers * log(registers / emptyRegisters);
+	}
+
+	return estimate;
+}
+
+// Displays every statistic to out
+void WordStats::display(ostream& out) const
+{
+	int	i;
+
+
+	out << "Words:              " << _words << endl;
+	out << "Distinct (approx):  " << (long long)distinctWords() << endl;
+	out << "Also donor words:   " << _corpusWords << endl;
+
+	out << "Lengths:           ";
+	for (i = 0; i < MAX_CHAR; ++i)
+	{
+		if (_lengths[i] > 0)
+		{
+			out << " " << i << ":" << _lengths[i];
+		}
+	}
+	out << endl;
+
+	out << "Letters:           ";
+	for (i = 0; i < STATS_LETTERS; ++i)
+	{
+		if (_letters[i] > 0)
+		{
+			out << " " << ((i < STATS_LETTERS - 1) ? (char)('a' + i) : '?') << ":" << _letters[i];
+		}
+	}
+	out << endl;
+
+	out << "Most frequent:     ";
+	for (i = 0; i < _topCount; ++i)
+	{
+		out << " " << _topWords[i].word << ":" << _topWords[i].count;
+	}
+	out << endl;
+}
+
+
+
+// Returns the 64-bit hash of word
+// (64-bit FNV-1a followed by a murmur3 finalizer so every bit depends on every char)
+unsigned long long WordStats::hashWord(const char word[])
+{
+	unsigned long long	hash = 14695981039346656037ULL;
+	int			i;
+
+
+	for (i = 0; word[i] != '\0'; ++i)
+	{
+		hash ^= (unsigned char)word[i];
+		hash *= 1099511628211ULL;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+// Returns the count-min estimate of the word with the given hash
+unsigned int WordStats::estimate(const unsigned long long& hash) const
+{
+	unsigned int	count = 0xFFFFFFFFu;
+	int		row;
+
+
+	for (row = 0; row < STATS_CM_DEPTH; ++row)
+	{
+		count = min(count, _counters[row][(hash >> (row * 16)) % STATS_CM_WIDTH]);
+	}
+
+	return count;
+}
+
+// Puts word in _topWords if its estimate is among the highest
+void WordStats::updateTopWords(const char word[], const unsigned int& count)
+{
+	int	i;
+
+
+	// Most words are rare, so bail out before touching the list
+	if ((_topCount == STATS_TOP_WORDS) && (count <= _topWords[_topCount - 1].count))
+	{
+		return;
+	}
+
+	// Find the word's current entry, or take the last one
+	for (i = 0; i < _topCount; ++i)
+	{
+		if (!strcmp(_topWords[i].word, word))
+		{
+			break;
+		}
+	}
+	if (i == _topCount)
+	{
+		if (_topCount < STATS_TOP_WORDS)
+		{
+			++_topCount;
+		}
+		i = _topCount - 1;
+		stringCopy(_topWords[i].word, MAX_CHAR, word);
+	}
+	_topWords[i].count = count;
+
+	// Then bubble it up to keep the list highest first
+	while ((i > 0) && (_topWords[i].count > _topWords[i - 1].count))
+	{
+		swap(_topWords[i], _topWords[i - 1]);
+		--i;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+#include "utilities.h"
+#include "letterSampler.h"
+
+
+// WORD STATISTICS SETTINGS
+// Sizes of the fixed-size sketches, so memory stays the same however many words are counted
+const int STATS_HLL_BITS = 14;				// HyperLogLog uses 2^STATS_HLL_BITS registers (about 0.8% error)
+const int STATS_HLL_REGISTERS = 1 << STATS_HLL_BITS;
+const int STATS_CM_DEPTH = 4;				// Rows of the count-min sketch
+const int STATS_CM_WIDTH = 4096;			// Counters per row of the count-min sketch
+const int STATS_TOP_WORDS = 10;				// Most frequent words kept for the report
+const int STATS_LETTERS = LETTER_COUNT + 1;		// letterIndex() of each char: 'a'-'z' without regard to case, then LETTER_NONE for everything else
+
+
+// Online statistics for a stream of generated words
+//
+// Distinct words are estimated with HyperLogLog, the most frequent words with a count-min
+// sketch, and lengths and letters are counted exactly in fixed-size histograms. Each thread
+// keeps its own WordStats and the results are combined with merge(), which is as cheap as
+// adding the sketches together.
+class WordStats
+{
+public:
+	// Constructor
+	// Starts with nothing counted
+	WordStats();
+
+	// Counts one generated word
+	// inCorpus is true if the word is also a donor word
+	void addWord(const char word[], const bool& inCorpus);
+	//
+	// Adds everything other has counted into this WordStats
+	void merge(const WordStats& other);
+
+	// Returns the number of words counted
+	long long words() const;
+	//
+	// Returns the estimated number of distinct words counted
+	double distinctWords() const;
+	//
+	// Displays every statistic to out
+	void display(ostream& out) const;
+
+private:
+	// One entry of the most-frequent-words list
+	struct TopWord
+	{
+		char		word[MAX_CHAR];	// The word
+		unsigned int	count;		// Its count-min estimate when last seen
+	};
+
+	long long	_words;						// Words counted
+	long long	_corpusWords;					// Words that are also donor words
+	long long	_lengths[MAX_CHAR];				// Words of each length
+	long long	_letters[STATS_LETTERS];			// Letters of each kind
+	unsigned char	_registers[STATS_HLL_REGISTERS];		// HyperLogLog registers
+	unsigned int	_counters[STATS_CM_DEPTH][STATS_CM_WIDTH];	// Count-min counters
+	TopWord		_topWords[STATS_TOP_WORDS];			// Most frequent words seen, highest first
+	int		_topCount;					// Entries used in _topWords
+
+
+
+	// Returns the 64-bit hash of word
+	static unsigned long long hashWord(const char word[]);
+	//
+	// Returns the count-min estimate of the word with the given hash
+	unsigned int estimate(const unsigned long long& hash) const;
+	//
+	// Puts word in _topWords if its estimate is among the highest
+	void updateTopWords(const char word[], const unsigned int& count);
+};
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "selfTest.h"
+#include "wordStats.h"
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+// WORD STATISTICS TEST SETTINGS
+const int STATS_TEST_DISTINCT = 100000;		// Different words counted for the distinct estimate
+const int STATS_TEST_RARE = 20000;		// Words seen once in each half of the merge stream
+const int STATS_TEST_REPEATS = 40;		// Times the least repeated of the frequent words is seen in each half
+const int STATS_TEST_TOP_WORDS = STATS_TOP_WORDS;	// Frequent words, each seen STATS_TEST_REPEATS times more than the one before
+
+
+
+// Returns a made-up word, different for every number, with letters, a length, and a case that vary
+static string statsWord(int number)
+{
+	string	word;
+
+	do
+	{
+		word += (char)(((number % 7) == 0 ? 'A' : 'a') + (number % 26));
+		number /= 26;
+	} while (number > 0);
+
+	return word;
+}
+
+// Counts half of the merge stream into stats: its rare words, then the frequent words, heaviest last
+// The frequent words come last so the count each had when last seen is its final estimate
+static void addHalf(WordStats& stats, const int& half)
+{
+	char	frequent[MAX_CHAR];
+	int	i;
+	int	j;
+
+
+	for (i = 0; i < STATS_TEST_RARE; ++i)
+	{
+		stats.addWord(statsWord(half * STATS_TEST_RARE + i).c_str(), (i % 5) == 0);
+	}
+	for (i = 0; i < STATS_TEST_TOP_WORDS; ++i)
+	{
+		snprintf(frequent, MAX_CHAR, "frequent%c", (char)('a' + i));
+		for (j = 0; j < STATS_TEST_REPEATS * (i + 1); ++j)
+		{
+			stats.addWord(frequent, false);
+		}
+	}
+}
+
+// Returns the report of stats
+static string report(const WordStats& stats)
+{
+	stringstream	out;
+
+	stats.display(out);
+
+	return out.str();
+}
+
+// Checks the HyperLogLog estimate against a known number of distinct words
+static void testDistinct()
+{
+	WordStats	stats;
+	int		i;
+
+
+	for (i = 0; i < STATS_TEST_DISTINCT; ++i)
+	{
+		stats.addWord(statsWord(i).c_str(), false);
+		if ((i % 10) == 0)
+		{
+			stats.addWord(statsWord(i).c_str(), false);
+		}
+	}
+
+	selfCheck(stats.words() == STATS_TEST_DISTINCT + STATS_TEST_DISTINCT / 10, "every word is counted, repeats included");
+	selfCheck(fabs(stats.distinctWords() - STATS_TEST_DISTINCT) < 0.02 * STATS_TEST_DISTINCT,
+		"distinctWords() is within 2% of 100000 distinct words");
+}
+
+// Checks that merging the stats of a stream split in two gives the stats of the whole stream
+static void testMerge()
+{
+	WordStats	whole;
+	WordStats	first;
+	WordStats	second;
+
+
+	addHalf(whole, 0);
+	addHalf(whole, 1);
+	addHalf(first, 0);
+	addHalf(second, 1);
+	first.merge(second);
+
+	selfCheck((first.words() == whole.words()) && (first.distinctWords() == whole.distinctWords()),
+		"merged halves count the words and distinct words of the whole stream");
+	selfCheck(report(first) == report(whole), "merged halves have the counts, histograms, and top words of the whole stream");
+}
+
+// Checks the top words and the words also in the corpus
+static void testReport()
+{
+	WordStats	stats;
+	string		text;
+	int		i;
+
+
+	for (i = 0; i < 5000; ++i)
+	{
+		stats.addWord(statsWord(i).c_str(), (i % 100) == 0);
+		if ((i % 4) == 0)
+		{
+			stats.addWord("often", true);
+		}
+	}
+	text = report(stats);
+
+	selfCheck(text.find("Most frequent:      often:1250") != string::npos, "a heavily repeated word ranks first with its count");
+	selfCheck(text.find("Also donor words:   1300\n") != string::npos, "words also in the corpus are counted");
+	selfCheck(text.find("Words:              6250\n") == 0, "the report starts with every word counted");
+}
+
+
+
+// HyperLogLog, count-min top words, histograms, and merging of word statistics
+void testWordStats()
+{
+	testDistinct();
+	testMerge();
+	testReport();
+}
\ No newline at end of file